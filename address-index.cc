@@ -0,0 +1,83 @@
+#include "address-index.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("AddressIndex");
+
+AddressIndex::AddressIndex(const Ipv4InterfaceContainer& interfaces, Ipv4Mask mask)
+    : m_network(0)
+{
+    uint32_t nNodes = interfaces.GetN();
+    if (nNodes == 0)
+    {
+        return;
+    }
+    m_network = interfaces.GetAddress(0).Get() & mask.Get();
+    m_nodes.assign(uint64_t(~mask.Get()) + 1, NONE);
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        Ipv4Address address = interfaces.GetAddress(i);
+        NS_ABORT_MSG_IF((address.Get() & mask.Get()) != m_network,
+                        "Address " << address << " of node " << i << " is outside the subnet");
+        m_nodes[address.Get() - m_network] = i;
+        m_addresses.push_back(address);
+    }
+    NS_LOG_INFO("Indexed " << nNodes << " node addresses, /" << mask.GetPrefixLength());
+}
+
+uint32_t
+AddressIndex::GetPrefixLength(uint32_t nNodes)
+{
+    // Host bits for nNodes plus the network and broadcast addresses
+    uint32_t hostBits = 9;
+    while (hostBits < 24 && (uint64_t(1) << hostBits) - 2 < nNodes)
+    {
+        ++hostBits;
+    }
+    NS_ABORT_MSG_IF((uint64_t(1) << hostBits) - 2 < nNodes,
+                    nNodes << " nodes do not fit into 10.0.0.0/8");
+    return 32 - hostBits;
+}
+
+Ipv4Address
+AddressIndex::GetNetwork(uint32_t nNodes)
+{
+    // 10.1.0.0 is aligned down to a /16
+    return Ipv4Address(GetPrefixLength(nNodes) >= 16 ? "10.1.0.0" : "10.0.0.0");
+}
+
+Ipv4Mask
+AddressIndex::GetMask(uint32_t nNodes)
+{
+    return Ipv4Mask(~((uint32_t(1) << (32 - GetPrefixLength(nNodes))) - 1));
+}
+
+uint32_t
+AddressIndex::GetNNodes() const
+{
+    return m_addresses.size();
+}
+
+uint32_t
+AddressIndex::GetNode(Ipv4Address address) const
+{
+    uint32_t offset = address.Get() - m_network;
+    return offset < m_nodes.size() ? m_nodes[offset] : NONE;
+}
+
+Ipv4Address
+AddressIndex::GetAddress(uint32_t node) const
+{
+    // Trace destinations are range-checked when the traces are loaded
+    NS_ASSERT_MSG(node < m_addresses.size(),
+                  "Node " << node << " is not one of the " << m_addresses.size() << " nodes");
+    return m_addresses[node];
+}
+
+} // namespace ns3
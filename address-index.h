@@ -0,0 +1,46 @@
+#ifndef ADDRESS_INDEX_H
+#define ADDRESS_INDEX_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+// Constant-time mapping between the nodes of a single swarm subnet and their addresses,
+// built once from the installed interfaces. Addresses are looked up by their offset from
+// the network address in a dense array, so it does not rely on the low octet matching the
+// node index and holds for any subnet size.
+class AddressIndex : public SimpleRefCount<AddressIndex>
+{
+  public:
+    static constexpr uint32_t NONE = 0xffffffff;
+
+    // interfaces.Get(i) is the interface of node i
+    AddressIndex(const Ipv4InterfaceContainer& interfaces, Ipv4Mask mask);
+
+    // Subnet of the address plan for nNodes: 10.1.0.0/23 up to 510 nodes, as the existing
+    // traces assume, then the smallest prefix that fits, down to 10.0.0.0/8
+    static Ipv4Address GetNetwork(uint32_t nNodes);
+    static Ipv4Mask GetMask(uint32_t nNodes);
+
+    uint32_t GetNNodes() const;
+    // Node holding address, NONE if it is not a node address of the subnet
+    uint32_t GetNode(Ipv4Address address) const;
+    Ipv4Address GetAddress(uint32_t node) const;
+
+  private:
+    static uint32_t GetPrefixLength(uint32_t nNodes);
+
+    uint32_t m_network;
+    std::vector<uint32_t> m_nodes;         // by host offset from m_network
+    std::vector<Ipv4Address> m_addresses; // by node
+};
+
+} // namespace ns3
+
+#endif // ADDRESS_INDEX_H
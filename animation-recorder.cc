@@ -0,0 +1,184 @@
+#include "animation-recorder.h"
+
+#include "position-sampler.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("AnimationRecorder");
+
+namespace
+{
+struct AnimationHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nNodes;
+    uint32_t packetSampling;
+    int64_t interval; // nanoseconds
+};
+
+struct ChunkHeader
+{
+    uint32_t type;
+    uint32_t count;
+    int64_t time; // nanoseconds
+};
+
+static_assert(sizeof(AnimationHeader) == 24, "AnimationHeader must be 24 bytes");
+static_assert(sizeof(ChunkHeader) == 16, "ChunkHeader must be 16 bytes");
+static_assert(sizeof(AnimationRecorder::PacketEvent) == 24,
+              "PacketEvent records must be 24 bytes");
+
+const char ANIMATION_MAGIC[4] = {'F', 'L', 'S', 'A'};
+const uint32_t ANIMATION_VERSION = 1;
+} // namespace
+
+AnimationRecorder::AnimationRecorder(const NodeContainer& nodes,
+                                     Ptr<MobilityStore> store,
+                                     Time interval,
+                                     uint32_t packetSampling)
+    : m_nodes(nodes),
+      m_store(store),
+      m_interval(interval),
+      m_packetSampling(packetSampling),
+      m_positions(3 * nodes.GetN()),
+      m_nPacketEvents(0)
+{
+    NS_ASSERT(interval.IsStrictlyPositive());
+}
+
+bool
+AnimationRecorder::Open(const std::string& filename)
+{
+    m_file.open(filename, std::ios::binary);
+    if (!m_file)
+    {
+        NS_LOG_ERROR("Unable to write animation file " << filename);
+        return false;
+    }
+    AnimationHeader header;
+    std::memcpy(header.magic, ANIMATION_MAGIC, 4);
+    header.version = ANIMATION_VERSION;
+    header.nNodes = m_nodes.GetN();
+    header.packetSampling = m_packetSampling;
+    header.interval = m_interval.GetNanoSeconds();
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return true;
+}
+
+void
+AnimationRecorder::Start()
+{
+    if (m_packetSampling > 0)
+    {
+        for (uint32_t i = 0; i < m_nodes.GetN(); ++i)
+        {
+            Ptr<Node> node = m_nodes.Get(i);
+            for (uint32_t j = 0; j < node->GetNDevices(); ++j)
+            {
+                Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(node->GetDevice(j));
+                if (device)
+                {
+                    device->GetPhy()->TraceConnectWithoutContext(
+                        "PhyTxBegin",
+                        MakeBoundCallback(&AnimationRecorder::PhyTxBegin, this, i));
+                    device->GetPhy()->TraceConnectWithoutContext(
+                        "PhyRxEnd",
+                        MakeBoundCallback(&AnimationRecorder::PhyRxEnd, this, i));
+                }
+            }
+        }
+    }
+    WritePositions();
+}
+
+void
+AnimationRecorder::Finish()
+{
+    FlushPackets();
+    m_file.close();
+    NS_LOG_INFO("Recorded " << m_nPacketEvents << " packet events");
+}
+
+uint64_t
+AnimationRecorder::GetNPacketEvents() const
+{
+    return m_nPacketEvents;
+}
+
+void
+AnimationRecorder::PhyTxBegin(AnimationRecorder* recorder,
+                              uint32_t node,
+                              Ptr<const Packet> packet,
+                              double /* txPowerW */)
+{
+    recorder->Record(node, packet, TX);
+}
+
+void
+AnimationRecorder::PhyRxEnd(AnimationRecorder* recorder, uint32_t node, Ptr<const Packet> packet)
+{
+    recorder->Record(node, packet, RX);
+}
+
+void
+AnimationRecorder::Record(uint32_t node, Ptr<const Packet> packet, EventType type)
+{
+    uint64_t uid = packet->GetUid();
+    if (uid % m_packetSampling != 0)
+    {
+        return;
+    }
+    uint16_t size = std::min<uint32_t>(packet->GetSize(), UINT16_MAX);
+    m_events.push_back(
+        PacketEvent{Simulator::Now().GetNanoSeconds(), uid, node, size, uint16_t(type)});
+    m_nPacketEvents++;
+}
+
+void
+AnimationRecorder::WriteChunk(ChunkType type, uint32_t count, const void* data, uint64_t size)
+{
+    ChunkHeader header{type, count, Simulator::Now().GetNanoSeconds()};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(reinterpret_cast<const char*>(data), size);
+    const char padding[8] = {};
+    m_file.write(padding, (8 - size % 8) % 8);
+}
+
+void
+AnimationRecorder::WritePositions()
+{
+    // Same snapshots as the rest of the run asks for at this instant
+    GetNodePositions(m_nodes, m_store, nullptr, m_positions.data());
+
+    // Packets of the previous interval, then the frame that ends it
+    FlushPackets();
+    WriteChunk(POSITIONS,
+               m_nodes.GetN(),
+               m_positions.data(),
+               m_positions.size() * sizeof(float));
+    Simulator::Schedule(m_interval, &AnimationRecorder::WritePositions, this);
+}
+
+void
+AnimationRecorder::FlushPackets()
+{
+    if (!m_events.empty())
+    {
+        WriteChunk(PACKETS,
+                   m_events.size(),
+                   m_events.data(),
+                   m_events.size() * sizeof(PacketEvent));
+        m_events.clear();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,91 @@
+#ifndef ANIMATION_RECORDER_H
+#define ANIMATION_RECORDER_H
+
+#include "mobility-store.h"
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Compact replacement for NetAnim's XML trace: node positions every interval and a
+// sample of the wifi transmissions and receptions, streamed to a binary file that
+// server/export_netanim.py turns into NetAnim XML when an animation is wanted.
+//
+// Packets are sampled by UID, 1 in packetSampling, so a sampled frame keeps its
+// transmission and all its receptions. Nothing is serialized per packet otherwise.
+//
+// Animation files ("FLSA") hold a 24-byte header (magic, version, node count, packet
+// sampling, interval in ns) followed by chunks. Each chunk starts with 16 bytes (type,
+// count, time in ns): a POSITIONS chunk holds count float32 x, y, z triples, a PACKETS
+// chunk count 24-byte PacketEvent records. Chunks are 8-byte aligned.
+class AnimationRecorder : public SimpleRefCount<AnimationRecorder>
+{
+  public:
+    enum ChunkType : uint32_t
+    {
+        POSITIONS = 0,
+        PACKETS = 1,
+    };
+
+    enum EventType : uint32_t
+    {
+        TX = 0,
+        RX = 1,
+    };
+
+    struct PacketEvent
+    {
+        int64_t time; // nanoseconds
+        uint64_t uid;
+        uint32_t node;
+        uint16_t size;
+        uint16_t type;
+    };
+
+    // Positions come from store snapshots, or from the mobility models if store is null.
+    // packetSampling 0 records no packets.
+    AnimationRecorder(const NodeContainer& nodes,
+                      Ptr<MobilityStore> store,
+                      Time interval,
+                      uint32_t packetSampling);
+
+    bool Open(const std::string& filename);
+    // Hooks the wifi PHYs and records positions from now on
+    void Start();
+    void Finish();
+
+    uint64_t GetNPacketEvents() const;
+
+  private:
+    static void PhyTxBegin(AnimationRecorder* recorder,
+                           uint32_t node,
+                           Ptr<const Packet> packet,
+                           double txPowerW);
+    static void PhyRxEnd(AnimationRecorder* recorder, uint32_t node, Ptr<const Packet> packet);
+    void Record(uint32_t node, Ptr<const Packet> packet, EventType type);
+    void WriteChunk(ChunkType type, uint32_t count, const void* data, uint64_t size);
+    void WritePositions();
+    void FlushPackets();
+
+    NodeContainer m_nodes;
+    Ptr<MobilityStore> m_store;
+    Time m_interval;
+    uint32_t m_packetSampling;
+    std::ofstream m_file;
+    std::vector<float> m_positions;
+    std::vector<PacketEvent> m_events; // since the last positions chunk
+    uint64_t m_nPacketEvents;
+};
+
+} // namespace ns3
+
+#endif // ANIMATION_RECORDER_H
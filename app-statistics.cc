@@ -0,0 +1,170 @@
+#include "app-statistics.h"
+
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace ns3
+{
+
+AppStatistics::AppStatistics(uint32_t nNodes)
+    : m_nNodes(nNodes),
+      m_txBytes(nNodes, 0),
+      m_rxBytes(nNodes, 0),
+      m_txPackets(nNodes, 0),
+      m_rxPackets(nNodes, 0),
+      m_unicastSent(nNodes, 0),
+      m_unicastDelivered(nNodes, 0),
+      m_delaySum(nNodes, 0),
+      m_jitterSum(nNodes, 0),
+      m_jitterSamples(nNodes, 0),
+      m_lastDelay(nNodes)
+{
+}
+
+void
+AppStatistics::NotifySent(uint32_t node, uint32_t bytes, bool unicast)
+{
+    m_txPackets[node]++;
+    m_txBytes[node] += bytes + IP_UDP_HEADER_SIZE;
+    m_unicastSent[node] += unicast;
+}
+
+void
+AppStatistics::NotifyReceived(uint32_t node, uint32_t bytes, const FlsHeader& header)
+{
+    int64_t delay = (Simulator::Now() - header.GetSendTime()).GetNanoSeconds();
+    m_rxPackets[node]++;
+    m_rxBytes[node] += bytes + IP_UDP_HEADER_SIZE;
+    m_delaySum[node] += delay;
+    uint32_t source = header.GetSource();
+    if (source >= m_nNodes)
+    {
+        return;
+    }
+    if (header.IsUnicast())
+    {
+        m_unicastDelivered[source]++;
+    }
+
+    int64_t& last = GetLastDelay(node, source);
+    if (last != NO_DELAY)
+    {
+        m_jitterSum[node] += std::abs(delay - last);
+        m_jitterSamples[node]++;
+    }
+    last = delay;
+}
+
+int64_t&
+AppStatistics::GetLastDelay(uint32_t node, uint32_t source)
+{
+    DelayTable& table = m_lastDelay[node];
+    if (!table.slots.empty())
+    {
+        DelaySlot& slot = Probe(table, source);
+        if (slot.source == source)
+        {
+            return slot.delay;
+        }
+    }
+
+    // Grow past three quarters full, probe sequences stay short
+    if (4 * (uint64_t(table.size) + 1) > 3 * table.slots.size())
+    {
+        Grow(table);
+    }
+    DelaySlot& slot = Probe(table, source);
+    slot.source = source;
+    slot.delay = NO_DELAY;
+    table.size++;
+    return slot.delay;
+}
+
+AppStatistics::DelaySlot&
+AppStatistics::Probe(DelayTable& table, uint32_t source)
+{
+    // Slot holding source, or the free slot ending its probe sequence
+    uint64_t mask = table.slots.size() - 1;
+    uint64_t i = (source * 0x9e3779b97f4a7c15ULL) >> table.shift;
+    while (table.slots[i].source != source && table.slots[i].source != NO_SOURCE)
+    {
+        i = (i + 1) & mask;
+    }
+    return table.slots[i];
+}
+
+void
+AppStatistics::Grow(DelayTable& table)
+{
+    std::vector<DelaySlot> old(std::max<size_t>(8, 2 * table.slots.size()),
+                               DelaySlot{NO_DELAY, NO_SOURCE});
+    old.swap(table.slots);
+    table.shift = 64 - __builtin_ctzll(table.slots.size());
+    for (const DelaySlot& slot : old)
+    {
+        if (slot.source != NO_SOURCE)
+        {
+            Probe(table, slot.source) = slot;
+        }
+    }
+}
+
+uint32_t
+AppStatistics::GetNNodes() const
+{
+    return m_nNodes;
+}
+
+uint64_t
+AppStatistics::GetTxBytes(uint32_t node) const
+{
+    return m_txBytes[node];
+}
+
+uint64_t
+AppStatistics::GetRxBytes(uint32_t node) const
+{
+    return m_rxBytes[node];
+}
+
+uint32_t
+AppStatistics::GetTxPackets(uint32_t node) const
+{
+    return m_txPackets[node];
+}
+
+uint32_t
+AppStatistics::GetRxPackets(uint32_t node) const
+{
+    return m_rxPackets[node];
+}
+
+uint32_t
+AppStatistics::GetLostPackets(uint32_t node) const
+{
+    // A duplicated delivery must not make the loss negative
+    return m_unicastSent[node] - std::min(m_unicastDelivered[node], m_unicastSent[node]);
+}
+
+double
+AppStatistics::GetDelaySum(uint32_t node) const
+{
+    return m_delaySum[node] * 1e-9;
+}
+
+double
+AppStatistics::GetJitterSum(uint32_t node) const
+{
+    return m_jitterSum[node] * 1e-9;
+}
+
+uint32_t
+AppStatistics::GetJitterSamples(uint32_t node) const
+{
+    return m_jitterSamples[node];
+}
+
+} // namespace ns3
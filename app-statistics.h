@@ -0,0 +1,85 @@
+#ifndef APP_STATISTICS_H
+#define APP_STATISTICS_H
+
+#include "fls-header.h"
+
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+// Per-node traffic counters kept at the application layer, from the FlsHeader of every
+// received packet, in flat arrays indexed by node. Gives StatisticsManager the same
+// per-node figures as FlowMonitor without hooking the IPv4 stack of every node or
+// keeping per-packet state.
+//
+// Loss is counted for unicast packets only: sent by the source and never received.
+// Jitter is the mean difference between the delays of consecutive packets of the same
+// source at a receiver, as FlowMonitor computes it per flow. Bytes include the IPv4 and
+// UDP headers, as FlowMonitor counts them.
+class AppStatistics : public SimpleRefCount<AppStatistics>
+{
+  public:
+    explicit AppStatistics(uint32_t nNodes);
+
+    void NotifySent(uint32_t node, uint32_t bytes, bool unicast);
+    void NotifyReceived(uint32_t node, uint32_t bytes, const FlsHeader& header);
+
+    uint32_t GetNNodes() const;
+    uint64_t GetTxBytes(uint32_t node) const;
+    uint64_t GetRxBytes(uint32_t node) const;
+    uint32_t GetTxPackets(uint32_t node) const;
+    uint32_t GetRxPackets(uint32_t node) const;
+    uint32_t GetLostPackets(uint32_t node) const;
+    // Seconds, summed over the packets node received
+    double GetDelaySum(uint32_t node) const;
+    double GetJitterSum(uint32_t node) const;
+    uint32_t GetJitterSamples(uint32_t node) const;
+
+  private:
+    // IPv4 (20 bytes) and UDP (8 bytes) headers of every packet
+    static constexpr uint32_t IP_UDP_HEADER_SIZE = 28;
+    // No packet from this source yet
+    static constexpr int64_t NO_DELAY = INT64_MIN;
+    // Free slot of a delay table
+    static constexpr uint32_t NO_SOURCE = UINT32_MAX;
+
+    struct DelaySlot
+    {
+        int64_t delay; // nanoseconds
+        uint32_t source;
+    };
+
+    // Open-addressing table (linear probing) of the sources a receiver heard from, so
+    // memory follows the pairs that communicate rather than the square of the swarm
+    struct DelayTable
+    {
+        std::vector<DelaySlot> slots; // power of two, empty until the first packet
+        uint32_t size = 0;
+        uint32_t shift = 64; // hash bits are the top log2(slots.size()) of the product
+    };
+
+    // Delay of the last packet from source at node, NO_DELAY if inserted by this call
+    int64_t& GetLastDelay(uint32_t node, uint32_t source);
+    static DelaySlot& Probe(DelayTable& table, uint32_t source);
+    static void Grow(DelayTable& table);
+
+    uint32_t m_nNodes;
+    std::vector<uint64_t> m_txBytes;
+    std::vector<uint64_t> m_rxBytes;
+    std::vector<uint32_t> m_txPackets;
+    std::vector<uint32_t> m_rxPackets;
+    std::vector<uint32_t> m_unicastSent;
+    std::vector<uint32_t> m_unicastDelivered; // by source
+    std::vector<int64_t> m_delaySum;          // nanoseconds
+    std::vector<int64_t> m_jitterSum;
+    std::vector<uint32_t> m_jitterSamples;
+    std::vector<DelayTable> m_lastDelay; // per receiver
+};
+
+} // namespace ns3
+
+#endif // APP_STATISTICS_H
@@ -0,0 +1,54 @@
+#ifndef BINARY_TRACE_H
+#define BINARY_TRACE_H
+
+#include <cstdint>
+
+namespace ns3
+{
+
+// Binary trace files, written by traces/convert_traces.py. All fields are little-endian.
+//
+// Mobility trace ("FLSM"): header, then `count` int64 keyframe times in nanoseconds
+// (strictly increasing), then `count` float32 x, `count` float32 y and `count` float32 z.
+//
+// Packet trace ("FLST"): header, then `count` PacketTrace records sorted by timestamp.
+//
+// Scenario bundle ("FLSB", written by traces/pack_scenario.py): BundleHeader, then one
+// BundleNodeEntry per node, then for every node its mobility keyframes (same layout as
+// a mobility trace without header) and its PacketTrace records, 8-byte aligned.
+struct BinaryTraceHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+};
+
+static_assert(sizeof(BinaryTraceHeader) == 16, "BinaryTraceHeader must be 16 bytes");
+
+struct BundleHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nNodes;
+    uint32_t reserved;
+};
+
+struct BundleNodeEntry
+{
+    uint64_t mobilityOffset; // from the start of the file
+    uint64_t mobilityCount;
+    uint64_t packetOffset;
+    uint64_t packetCount;
+};
+
+static_assert(sizeof(BundleHeader) == 16, "BundleHeader must be 16 bytes");
+static_assert(sizeof(BundleNodeEntry) == 32, "BundleNodeEntry must be 32 bytes");
+
+const char BINARY_MOBILITY_TRACE_MAGIC[4] = {'F', 'L', 'S', 'M'};
+const char BINARY_PACKET_TRACE_MAGIC[4] = {'F', 'L', 'S', 'T'};
+const char SCENARIO_BUNDLE_MAGIC[4] = {'F', 'L', 'S', 'B'};
+const uint32_t BINARY_TRACE_VERSION = 1;
+
+} // namespace ns3
+
+#endif // BINARY_TRACE_H
@@ -0,0 +1,419 @@
+#include "contact-plan.h"
+
+#include "mapped-file.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <tuple>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("ContactPlan");
+
+namespace
+{
+struct ContactPlanHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nNodes;
+    uint32_t reserved;
+    double range;
+    uint64_t fingerprint;
+    uint64_t count;
+};
+
+static_assert(sizeof(ContactPlanHeader) == 40, "ContactPlanHeader must be 40 bytes");
+static_assert(sizeof(ContactPlan::Contact) == 24, "Contact records must be 24 bytes");
+
+const char CONTACT_PLAN_MAGIC[4] = {'F', 'L', 'S', 'C'};
+const uint32_t CONTACT_PLAN_VERSION = 2;
+const int64_t NO_CONTACT = std::numeric_limits<int64_t>::min();
+
+// Squared distance minus range^2 of node i to nodes j over one keyframe interval, as
+// a s^2 + b s + c for s seconds into the interval. Vectorized by the compiler.
+void
+PairQuadratics(uint32_t count,
+               const double* p,
+               const double* v,
+               const double* __restrict x,
+               const double* __restrict y,
+               const double* __restrict z,
+               const double* __restrict vx,
+               const double* __restrict vy,
+               const double* __restrict vz,
+               double range2,
+               double* __restrict a,
+               double* __restrict b,
+               double* __restrict c)
+{
+    for (uint32_t j = 0; j < count; ++j)
+    {
+        double dx = x[j] - p[0];
+        double dy = y[j] - p[1];
+        double dz = z[j] - p[2];
+        double dvx = vx[j] - v[0];
+        double dvy = vy[j] - v[1];
+        double dvz = vz[j] - v[2];
+        a[j] = dvx * dvx + dvy * dvy + dvz * dvz;
+        b[j] = 2 * (dx * dvx + dy * dvy + dz * dvz);
+        c[j] = dx * dx + dy * dy + dz * dz - range2;
+    }
+}
+
+// Part [s1, s2] of [0, duration] where a s^2 + b s + c <= 0, false if there is none.
+// The quadratic is convex, so the part is a single interval.
+bool
+SolveContact(double a, double b, double c, double duration, double& s1, double& s2)
+{
+    if (a <= 0)
+    {
+        s1 = 0;
+        s2 = duration;
+        return c <= 0;
+    }
+    double discriminant = b * b - 4 * a * c;
+    if (discriminant < 0)
+    {
+        return false;
+    }
+    // Numerically stable roots
+    double q = -0.5 * (b + std::copysign(std::sqrt(discriminant), b));
+    double r1 = (q == 0) ? 0 : q / a;
+    double r2 = (q == 0) ? 0 : c / q;
+    s1 = std::max(std::min(r1, r2), 0.0);
+    s2 = std::min(std::max(r1, r2), duration);
+    return s1 <= s2;
+}
+} // namespace
+
+ContactPlan::ContactPlan()
+    : m_nNodes(0),
+      m_range(0),
+      m_fingerprint(0)
+{
+}
+
+Ptr<ContactPlan>
+ContactPlan::Compute(const MobilityStore& store, double range)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    Ptr<ContactPlan> plan = Create<ContactPlan>();
+    uint32_t n = store.GetNNodes();
+    plan->m_nNodes = n;
+    plan->m_range = range;
+    plan->m_fingerprint = store.GetFingerprint();
+
+    // Every node moves linearly between two consecutive keyframe times of the swarm
+    std::vector<int64_t> times(1, 0);
+    for (uint32_t node = 0; node < n; ++node)
+    {
+        MobilityStore::Track track = store.GetTrack(node);
+        for (uint32_t k = 0; k < track.size; ++k)
+        {
+            if (track.time[k] > 0)
+            {
+                times.push_back(track.time[k]);
+            }
+        }
+    }
+    std::sort(times.begin(), times.end());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+
+    std::vector<double> x(n), y(n), z(n);
+    std::vector<double> nextX(n), nextY(n), nextZ(n);
+    std::vector<double> vx(n, 0), vy(n, 0), vz(n, 0);
+    std::vector<double> a(n), b(n), c(n);
+    // Start of the contact of each pair (i < j) still open at the current interval
+    std::vector<int64_t> open(uint64_t(n) * (n > 0 ? n - 1 : 0) / 2, NO_CONTACT);
+    const double tolerance = 0.5e-9;
+
+    store.GetPositions(NanoSeconds(times[0]), x.data(), y.data(), z.data());
+    for (size_t k = 0; k < times.size(); ++k)
+    {
+        int64_t t0 = times[k];
+        double duration = std::numeric_limits<double>::infinity();
+        if (k + 1 < times.size())
+        {
+            duration = (times[k + 1] - t0) * 1e-9;
+            store.GetPositions(NanoSeconds(times[k + 1]),
+                               nextX.data(),
+                               nextY.data(),
+                               nextZ.data());
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                vx[i] = (nextX[i] - x[i]) / duration;
+                vy[i] = (nextY[i] - y[i]) / duration;
+                vz[i] = (nextZ[i] - z[i]) / duration;
+            }
+        }
+        else
+        {
+            // Every node holds its last keyframe from here on
+            std::fill(vx.begin(), vx.end(), 0);
+            std::fill(vy.begin(), vy.end(), 0);
+            std::fill(vz.begin(), vz.end(), 0);
+        }
+
+        uint64_t pair = 0;
+        for (uint32_t i = 0; i + 1 < n; ++i)
+        {
+            uint32_t count = n - i - 1;
+            double p[3] = {x[i], y[i], z[i]};
+            double v[3] = {vx[i], vy[i], vz[i]};
+            PairQuadratics(count,
+                           p,
+                           v,
+                           &x[i + 1],
+                           &y[i + 1],
+                           &z[i + 1],
+                           &vx[i + 1],
+                           &vy[i + 1],
+                           &vz[i + 1],
+                           range * range,
+                           a.data(),
+                           b.data(),
+                           c.data());
+
+            for (uint32_t j = 0; j < count; ++j, ++pair)
+            {
+                double s1;
+                double s2;
+                bool inRange = SolveContact(a[j], b[j], c[j], duration, s1, s2);
+                if (open[pair] != NO_CONTACT && (!inRange || s1 > tolerance))
+                {
+                    // The contact ended with the previous interval
+                    plan->m_contacts.push_back({open[pair], t0, i, i + 1 + j});
+                    open[pair] = NO_CONTACT;
+                }
+                if (!inRange)
+                {
+                    continue;
+                }
+                if (open[pair] == NO_CONTACT)
+                {
+                    open[pair] = t0 + std::llround(s1 * 1e9);
+                }
+                if (s2 < duration - tolerance)
+                {
+                    plan->m_contacts.push_back(
+                        {open[pair], t0 + std::llround(s2 * 1e9), i, i + 1 + j});
+                    open[pair] = NO_CONTACT;
+                }
+            }
+        }
+
+        x.swap(nextX);
+        y.swap(nextY);
+        z.swap(nextZ);
+    }
+
+    uint64_t pair = 0;
+    for (uint32_t i = 0; i + 1 < n; ++i)
+    {
+        for (uint32_t j = i + 1; j < n; ++j, ++pair)
+        {
+            if (open[pair] != NO_CONTACT)
+            {
+                plan->m_contacts.push_back(
+                    {open[pair], std::numeric_limits<int64_t>::max(), i, j});
+            }
+        }
+    }
+
+    std::sort(plan->m_contacts.begin(),
+              plan->m_contacts.end(),
+              [](const Contact& l, const Contact& r) {
+                  return std::tie(l.start, l.a, l.b) < std::tie(r.start, r.a, r.b);
+              });
+    plan->BuildIndex();
+
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    NS_LOG_INFO("Computed " << plan->m_contacts.size() << " contacts within " << range
+                            << " m for " << n << " nodes over " << times.size()
+                            << " keyframe intervals in " << elapsed * 1000 << " ms");
+    return plan;
+}
+
+Ptr<ContactPlan>
+ContactPlan::Load(const std::string& filename, const MobilityStore& store, double range)
+{
+    MappedFile file;
+    if (!file.Open(filename))
+    {
+        return nullptr;
+    }
+
+    const ContactPlanHeader* header = reinterpret_cast<const ContactPlanHeader*>(file.GetData());
+    if (file.GetSize() < sizeof(ContactPlanHeader) ||
+        std::memcmp(header->magic, CONTACT_PLAN_MAGIC, 4) != 0 ||
+        header->version != CONTACT_PLAN_VERSION ||
+        (file.GetSize() - sizeof(ContactPlanHeader)) % sizeof(Contact) != 0 ||
+        (file.GetSize() - sizeof(ContactPlanHeader)) / sizeof(Contact) != header->count)
+    {
+        NS_LOG_ERROR("Invalid contact plan file " << filename);
+        return nullptr;
+    }
+    if (header->nNodes != store.GetNNodes() || header->range != range)
+    {
+        NS_LOG_INFO("Contact plan " << filename << " was computed for " << header->nNodes
+                                    << " nodes within " << header->range << " m, ignoring it");
+        return nullptr;
+    }
+    // Same node count and range, but possibly another choreography or trace directory
+    uint64_t fingerprint = store.GetFingerprint();
+    if (header->fingerprint != fingerprint)
+    {
+        NS_LOG_INFO("Contact plan " << filename
+                                    << " was computed from other trajectories, ignoring it");
+        return nullptr;
+    }
+
+    Ptr<ContactPlan> plan = Create<ContactPlan>();
+    plan->m_nNodes = header->nNodes;
+    plan->m_range = range;
+    plan->m_fingerprint = fingerprint;
+    const Contact* contacts =
+        reinterpret_cast<const Contact*>(file.GetData() + sizeof(ContactPlanHeader));
+    plan->m_contacts.assign(contacts, contacts + header->count);
+    plan->BuildIndex();
+    NS_LOG_INFO("Loaded " << header->count << " contacts from " << filename);
+    return plan;
+}
+
+bool
+ContactPlan::Save(const std::string& filename) const
+{
+    // Written aside and renamed, so that concurrent runs never read a partial plan
+    std::string partial =
+        filename + ".part" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::ofstream file(partial, std::ios::binary);
+    if (!file)
+    {
+        NS_LOG_ERROR("Unable to write contact plan file " << filename);
+        return false;
+    }
+
+    ContactPlanHeader header;
+    std::memcpy(header.magic, CONTACT_PLAN_MAGIC, 4);
+    header.version = CONTACT_PLAN_VERSION;
+    header.nNodes = m_nNodes;
+    header.reserved = 0;
+    header.range = m_range;
+    header.fingerprint = m_fingerprint;
+    header.count = m_contacts.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_contacts.data()),
+               m_contacts.size() * sizeof(Contact));
+    file.close();
+    if (!file || std::rename(partial.c_str(), filename.c_str()) != 0)
+    {
+        NS_LOG_ERROR("Unable to write contact plan file " << filename);
+        std::remove(partial.c_str());
+        return false;
+    }
+    return true;
+}
+
+void
+ContactPlan::BuildIndex()
+{
+    m_nodeIndex.assign(m_nNodes, std::vector<uint32_t>());
+    m_changes.clear();
+    for (uint32_t i = 0; i < m_contacts.size(); ++i)
+    {
+        const Contact& contact = m_contacts[i];
+        m_nodeIndex[contact.a].push_back(i);
+        m_nodeIndex[contact.b].push_back(i);
+        m_changes.push_back(contact.start);
+        if (contact.end != std::numeric_limits<int64_t>::max())
+        {
+            // The end is inclusive, the pair is out of range one nanosecond later
+            m_changes.push_back(contact.end + 1);
+        }
+    }
+    std::sort(m_changes.begin(), m_changes.end());
+    m_changes.erase(std::unique(m_changes.begin(), m_changes.end()), m_changes.end());
+}
+
+uint32_t
+ContactPlan::GetNNodes() const
+{
+    return m_nNodes;
+}
+
+double
+ContactPlan::GetRange() const
+{
+    return m_range;
+}
+
+const std::vector<ContactPlan::Contact>&
+ContactPlan::GetContacts() const
+{
+    return m_contacts;
+}
+
+void
+ContactPlan::GetNeighbors(uint32_t node, Time t, std::vector<uint32_t>& neighbors) const
+{
+    NS_ASSERT(node < m_nNodes);
+    neighbors.clear();
+    int64_t now = t.GetNanoSeconds();
+
+    // Contacts are indexed by start time, so only the ones started by now are visited
+    const std::vector<uint32_t>& index = m_nodeIndex[node];
+    auto last = std::upper_bound(index.begin(), index.end(), now, [this](int64_t v, uint32_t c) {
+        return v < m_contacts[c].start;
+    });
+    for (auto it = index.begin(); it != last; ++it)
+    {
+        const Contact& contact = m_contacts[*it];
+        if (contact.end >= now)
+        {
+            neighbors.push_back(contact.a == node ? contact.b : contact.a);
+        }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+}
+
+bool
+ContactPlan::IsInContact(uint32_t a, uint32_t b, Time t) const
+{
+    NS_ASSERT(a < m_nNodes && b < m_nNodes);
+    int64_t now = t.GetNanoSeconds();
+    uint32_t node = (m_nodeIndex[a].size() <= m_nodeIndex[b].size()) ? a : b;
+    uint32_t peer = (node == a) ? b : a;
+    for (uint32_t c : m_nodeIndex[node])
+    {
+        const Contact& contact = m_contacts[c];
+        if (contact.start > now)
+        {
+            break;
+        }
+        if (contact.end >= now && (contact.a == peer || contact.b == peer))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Time
+ContactPlan::GetNextChange(Time t) const
+{
+    auto it = std::upper_bound(m_changes.begin(), m_changes.end(), t.GetNanoSeconds());
+    return (it == m_changes.end()) ? Time::Max() : NanoSeconds(*it);
+}
+
+} // namespace ns3
@@ -0,0 +1,69 @@
+#ifndef CONTACT_PLAN_H
+#define CONTACT_PLAN_H
+
+#include "mobility-store.h"
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Time-indexed connectivity of a trace-driven swarm: for every node pair, the intervals
+// during which the two nodes are within a given range. Between two consecutive keyframe
+// times of the whole swarm every node moves linearly, so the squared distance of a pair
+// is a quadratic in time and the contact boundaries are solved for exactly.
+//
+// Contact plan files ("FLSC") hold a 40-byte header (magic, version, node count, range,
+// fingerprint of the trajectories) followed by the contacts as 24-byte records, see Save().
+class ContactPlan : public SimpleRefCount<ContactPlan>
+{
+  public:
+    struct Contact
+    {
+        int64_t start; // nanoseconds, nodes are within range from start to end inclusive
+        int64_t end;   // INT64_MAX if the contact lasts until the end of the traces
+        uint32_t a;    // a < b
+        uint32_t b;
+    };
+
+    ContactPlan();
+
+    // Compute the contacts of every node pair of store at distance <= range (meters)
+    static Ptr<ContactPlan> Compute(const MobilityStore& store, double range);
+    // Read a plan written by Save(), nullptr if missing, invalid, or computed for other
+    // trajectories than those of store or another range
+    static Ptr<ContactPlan> Load(const std::string& filename,
+                                 const MobilityStore& store,
+                                 double range);
+    bool Save(const std::string& filename) const;
+
+    uint32_t GetNNodes() const;
+    double GetRange() const;
+    const std::vector<Contact>& GetContacts() const;
+
+    // Nodes within range of node at time t, in ascending order
+    void GetNeighbors(uint32_t node, Time t, std::vector<uint32_t>& neighbors) const;
+    bool IsInContact(uint32_t a, uint32_t b, Time t) const;
+    // First instant after t at which a contact starts or ends, Time::Max() if none
+    Time GetNextChange(Time t) const;
+
+  private:
+    void BuildIndex();
+
+    uint32_t m_nNodes;
+    double m_range;
+    uint64_t m_fingerprint; // MobilityStore::GetFingerprint() of the trajectories
+    std::vector<Contact> m_contacts;                // sorted by start time
+    std::vector<std::vector<uint32_t>> m_nodeIndex; // contacts of each node, by start time
+    std::vector<int64_t> m_changes;                 // sorted contact starts and ends
+};
+
+} // namespace ns3
+
+#endif // CONTACT_PLAN_H
@@ -0,0 +1,326 @@
+#include "contact-routing.h"
+
+#include "ns3/abort.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <utility>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("ContactRouting");
+
+namespace
+{
+void
+RemoveHostRoute(Ptr<Ipv4StaticRouting> routing, Ipv4Address dest)
+{
+    for (uint32_t i = 0; i < routing->GetNRoutes(); ++i)
+    {
+        Ipv4RoutingTableEntry route = routing->GetRoute(i);
+        if (route.IsHost() && route.GetDest() == dest)
+        {
+            routing->RemoveRoute(i);
+            return;
+        }
+    }
+}
+} // namespace
+
+ContactRouting::ContactRouting(Ptr<const ContactPlan> plan,
+                               const NodeContainer& nodes,
+                               uint32_t interface,
+                               uint32_t nThreads)
+    : m_plan(plan),
+      m_nNodes(nodes.GetN()),
+      m_interface(interface),
+      m_nThreads(nThreads),
+      m_neighbors(m_nNodes),
+      m_nUpdates(0),
+      m_nRecomputedTrees(0),
+      m_nRouteChanges(0)
+{
+    NS_ASSERT(plan->GetNNodes() == m_nNodes);
+    NS_ABORT_MSG_IF(m_nNodes >= NONE16,
+                    "Contact routing supports up to " << NONE16 - 1 << " nodes");
+    m_distance.assign(uint64_t(m_nNodes) * m_nNodes, NONE16);
+    m_parent.assign(uint64_t(m_nNodes) * m_nNodes, NONE16);
+    Ipv4StaticRoutingHelper helper;
+    for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+        Ptr<Ipv4> ipv4 = nodes.Get(i)->GetObject<Ipv4>();
+        m_addresses.push_back(ipv4->GetAddress(interface, 0).GetLocal());
+        m_routing.push_back(helper.GetStaticRouting(ipv4));
+        // Without links every node only reaches itself
+        m_distance[uint64_t(i) * m_nNodes + i] = 0;
+    }
+    if (m_nThreads == 0)
+    {
+        m_nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void
+ContactRouting::Start()
+{
+    Simulator::ScheduleNow(&ContactRouting::Update, this);
+}
+
+bool
+ContactRouting::IsAffected(uint32_t source, uint32_t u, uint32_t v, bool up) const
+{
+    const uint16_t* distance = &m_distance[uint64_t(source) * m_nNodes];
+    const uint16_t* parent = &m_parent[uint64_t(source) * m_nNodes];
+    if (!up)
+    {
+        // Only losing a tree edge changes distances or parents
+        return parent[v] == u || parent[u] == v;
+    }
+
+    if (distance[u] == distance[v])
+    {
+        return false;
+    }
+    if (distance[u] > distance[v])
+    {
+        std::swap(u, v);
+    }
+    // v gets closer, becomes reachable, or gets a lower-index parent
+    return distance[v] == NONE16 || distance[v] - distance[u] >= 2 || u < parent[v];
+}
+
+void
+ContactRouting::ComputeTree(uint32_t source, std::vector<uint32_t>& queue)
+{
+    uint64_t row = uint64_t(source) * m_nNodes;
+    uint16_t* distance = &m_distance[row];
+    uint16_t* parent = &m_parent[row];
+    std::fill(distance, distance + m_nNodes, NONE16);
+    std::fill(parent, parent + m_nNodes, NONE16);
+
+    distance[source] = 0;
+    queue.assign(1, source);
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        uint32_t u = queue[head];
+        for (uint32_t v : m_neighbors[u])
+        {
+            if (distance[v] == NONE16)
+            {
+                distance[v] = distance[u] + 1;
+                queue.push_back(v);
+            }
+        }
+    }
+
+    for (size_t i = 1; i < queue.size(); ++i)
+    {
+        uint32_t v = queue[i];
+        for (uint32_t u : m_neighbors[v])
+        {
+            if (distance[u] + 1 == distance[v])
+            {
+                parent[v] = u;
+                break;
+            }
+        }
+    }
+}
+
+void
+ContactRouting::GetFirstHops(uint32_t source,
+                             std::vector<uint32_t>& firstHop,
+                             std::vector<uint32_t>& path) const
+{
+    const uint16_t* parent = &m_parent[uint64_t(source) * m_nNodes];
+    firstHop.assign(m_nNodes, NONE);
+    for (uint32_t v = 0; v < m_nNodes; ++v)
+    {
+        // Climb to a child of source or to a node already resolved, then label the path
+        path.clear();
+        uint32_t u = v;
+        while (parent[u] != NONE16 && parent[u] != source && firstHop[u] == NONE)
+        {
+            path.push_back(u);
+            u = parent[u];
+        }
+        uint32_t hop = firstHop[u];
+        if (hop == NONE && parent[u] == source)
+        {
+            hop = u;
+        }
+        firstHop[u] = hop;
+        for (uint32_t w : path)
+        {
+            firstHop[w] = hop;
+        }
+    }
+}
+
+void
+ContactRouting::InstallRoutes(uint32_t source,
+                              const std::vector<uint32_t>& oldFirstHop,
+                              const std::vector<uint32_t>& firstHop)
+{
+    for (uint32_t dest = 0; dest < m_nNodes; ++dest)
+    {
+        uint32_t oldHop = oldFirstHop[dest];
+        uint32_t newHop = firstHop[dest];
+        bool hadRoute = (oldHop != NONE && oldHop != dest);
+        bool hasRoute = (newHop != NONE && newHop != dest);
+        if (hadRoute == hasRoute && (!hasRoute || oldHop == newHop))
+        {
+            continue;
+        }
+        if (hadRoute)
+        {
+            RemoveHostRoute(m_routing[source], m_addresses[dest]);
+        }
+        if (hasRoute)
+        {
+            m_routing[source]->AddHostRouteTo(m_addresses[dest],
+                                              m_addresses[newHop],
+                                              m_interface);
+        }
+        ++m_nRouteChanges;
+    }
+}
+
+void
+ContactRouting::Update()
+{
+    Time now = Simulator::Now();
+
+    // Links that went up or down since the previous update
+    std::vector<std::vector<uint32_t>> neighbors(m_nNodes);
+    std::vector<std::pair<uint32_t, uint32_t>> up;
+    std::vector<std::pair<uint32_t, uint32_t>> down;
+    for (uint32_t u = 0; u < m_nNodes; ++u)
+    {
+        m_plan->GetNeighbors(u, now, neighbors[u]);
+        std::vector<uint32_t> diff;
+        std::set_difference(neighbors[u].begin(),
+                            neighbors[u].end(),
+                            m_neighbors[u].begin(),
+                            m_neighbors[u].end(),
+                            std::back_inserter(diff));
+        for (uint32_t v : diff)
+        {
+            if (u < v)
+            {
+                up.emplace_back(u, v);
+            }
+        }
+        diff.clear();
+        std::set_difference(m_neighbors[u].begin(),
+                            m_neighbors[u].end(),
+                            neighbors[u].begin(),
+                            neighbors[u].end(),
+                            std::back_inserter(diff));
+        for (uint32_t v : diff)
+        {
+            if (u < v)
+            {
+                down.emplace_back(u, v);
+            }
+        }
+    }
+
+    // Trees are checked against the topology they were computed for
+    std::vector<uint32_t> affected;
+    for (uint32_t source = 0; source < m_nNodes; ++source)
+    {
+        bool isAffected = false;
+        for (size_t i = 0; i < up.size() && !isAffected; ++i)
+        {
+            isAffected = IsAffected(source, up[i].first, up[i].second, true);
+        }
+        for (size_t i = 0; i < down.size() && !isAffected; ++i)
+        {
+            isAffected = IsAffected(source, down[i].first, down[i].second, false);
+        }
+        if (isAffected)
+        {
+            affected.push_back(source);
+        }
+    }
+    m_neighbors.swap(neighbors);
+
+    // First hops are derived from the parents rather than stored for every source
+    std::vector<std::vector<uint32_t>> oldFirstHop(affected.size());
+    std::vector<uint32_t> path;
+    for (size_t i = 0; i < affected.size(); ++i)
+    {
+        GetFirstHops(affected[i], oldFirstHop[i], path);
+    }
+
+    // Trees are independent, recompute them in parallel; routes are installed afterwards
+    // on the simulation thread
+    std::atomic<size_t> next(0);
+    auto worker = [this, &affected, &next]() {
+        std::vector<uint32_t> queue;
+        size_t i;
+        while ((i = next.fetch_add(1)) < affected.size())
+        {
+            ComputeTree(affected[i], queue);
+        }
+    };
+    // Threads only pay off for larger batches of trees
+    uint32_t nThreads = std::min<size_t>(m_nThreads, affected.size() / 32 + 1);
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < nThreads; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : workers)
+    {
+        t.join();
+    }
+
+    uint64_t routeChanges = m_nRouteChanges;
+    std::vector<uint32_t> firstHop;
+    for (size_t i = 0; i < affected.size(); ++i)
+    {
+        GetFirstHops(affected[i], firstHop, path);
+        InstallRoutes(affected[i], oldFirstHop[i], firstHop);
+    }
+
+    ++m_nUpdates;
+    m_nRecomputedTrees += affected.size();
+    NS_LOG_DEBUG(now.GetSeconds() << "s: " << up.size() << " link(s) up, " << down.size()
+                                  << " down, " << affected.size() << " tree(s) recomputed, "
+                                  << m_nRouteChanges - routeChanges << " route(s) changed");
+
+    Time nextChange = m_plan->GetNextChange(now);
+    if (nextChange != Time::Max())
+    {
+        Simulator::Schedule(nextChange - now, &ContactRouting::Update, this);
+    }
+}
+
+uint32_t
+ContactRouting::GetNUpdates() const
+{
+    return m_nUpdates;
+}
+
+uint64_t
+ContactRouting::GetNRecomputedTrees() const
+{
+    return m_nRecomputedTrees;
+}
+
+uint64_t
+ContactRouting::GetNRouteChanges() const
+{
+    return m_nRouteChanges;
+}
+
+} // namespace ns3
@@ -0,0 +1,81 @@
+#ifndef CONTACT_ROUTING_H
+#define CONTACT_ROUTING_H
+
+#include "contact-plan.h"
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+// Multi-hop unicast routes that follow the swarm. Links are the node pairs in range
+// according to a contact plan; at every topology change only the shortest-path trees
+// affected by the links that went up or down are recomputed, on a pool of threads, and
+// the next hops that changed are installed as host routes into each node's
+// Ipv4StaticRouting. Destinations one hop away use the on-link subnet route.
+//
+// Paths minimize the hop count. Among equal-length paths the lowest-index parent wins,
+// so a tree only depends on the topology and incremental updates give the same routes
+// as a full recomputation.
+//
+// Every source keeps the hop count and parent of every node as 16-bit entries, 4 n^2
+// bytes in total (100 MB at 5,000 nodes), which limits contact routing to 65,534 nodes.
+class ContactRouting : public SimpleRefCount<ContactRouting>
+{
+  public:
+    // interface is the index of the wifi interface on every node's Ipv4
+    ContactRouting(Ptr<const ContactPlan> plan,
+                   const NodeContainer& nodes,
+                   uint32_t interface,
+                   uint32_t nThreads);
+
+    // Install the routes of time 0 and follow the plan's topology changes from there
+    void Start();
+
+    uint32_t GetNUpdates() const;
+    uint64_t GetNRecomputedTrees() const;
+    uint64_t GetNRouteChanges() const;
+
+  private:
+    void Update();
+    // Would a change of link (u, v) alter source's tree
+    bool IsAffected(uint32_t source, uint32_t u, uint32_t v, bool up) const;
+    // Hop-count tree of source over m_neighbors, into its rows of the tables
+    void ComputeTree(uint32_t source, std::vector<uint32_t>& queue);
+    // First hop from source towards every node (NONE if unreachable), from its parents
+    void GetFirstHops(uint32_t source,
+                      std::vector<uint32_t>& firstHop,
+                      std::vector<uint32_t>& path) const;
+    void InstallRoutes(uint32_t source,
+                       const std::vector<uint32_t>& oldFirstHop,
+                       const std::vector<uint32_t>& firstHop);
+
+    static constexpr uint32_t NONE = 0xffffffff;
+    static constexpr uint16_t NONE16 = 0xffff;
+
+    Ptr<const ContactPlan> m_plan;
+    uint32_t m_nNodes;
+    uint32_t m_interface;
+    uint32_t m_nThreads;
+    std::vector<Ipv4Address> m_addresses;
+    std::vector<Ptr<Ipv4StaticRouting>> m_routing;
+
+    std::vector<std::vector<uint32_t>> m_neighbors; // current topology, sorted
+    // Per source rows of m_nNodes entries, NONE16 if unreachable
+    std::vector<uint16_t> m_distance; // hops
+    std::vector<uint16_t> m_parent;
+
+    uint32_t m_nUpdates;
+    uint64_t m_nRecomputedTrees;
+    uint64_t m_nRouteChanges;
+};
+
+} // namespace ns3
+
+#endif // CONTACT_ROUTING_H
@@ -0,0 +1,117 @@
+#include "fls-header.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(FlsHeader);
+
+namespace
+{
+const uint32_t FLS_HEADER_UNICAST = 0x1;
+} // namespace
+
+TypeId
+FlsHeader::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::FlsHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("FLS")
+                            .AddConstructor<FlsHeader>();
+    return tid;
+}
+
+TypeId
+FlsHeader::GetInstanceTypeId(void) const
+{
+    return GetTypeId();
+}
+
+FlsHeader::FlsHeader()
+    : m_source(0),
+      m_sequence(0),
+      m_sendTime(0),
+      m_flags(0)
+{
+}
+
+uint32_t
+FlsHeader::GetSerializedSize(void) const
+{
+    return SERIALIZED_SIZE;
+}
+
+void
+FlsHeader::Serialize(Buffer::Iterator start) const
+{
+    start.WriteHtonU32(m_source);
+    start.WriteHtonU32(m_sequence);
+    start.WriteHtonU64(m_sendTime);
+    start.WriteHtonU32(m_flags);
+}
+
+uint32_t
+FlsHeader::Deserialize(Buffer::Iterator start)
+{
+    m_source = start.ReadNtohU32();
+    m_sequence = start.ReadNtohU32();
+    m_sendTime = start.ReadNtohU64();
+    m_flags = start.ReadNtohU32();
+    return SERIALIZED_SIZE;
+}
+
+void
+FlsHeader::Print(std::ostream& os) const
+{
+    os << "source=" << m_source << " seq=" << m_sequence << " sendTime=" << m_sendTime << "ns"
+       << (IsUnicast() ? " unicast" : " broadcast");
+}
+
+void
+FlsHeader::SetSource(uint32_t source)
+{
+    m_source = source;
+}
+
+uint32_t
+FlsHeader::GetSource() const
+{
+    return m_source;
+}
+
+void
+FlsHeader::SetSequence(uint32_t sequence)
+{
+    m_sequence = sequence;
+}
+
+uint32_t
+FlsHeader::GetSequence() const
+{
+    return m_sequence;
+}
+
+void
+FlsHeader::SetSendTime(Time sendTime)
+{
+    m_sendTime = sendTime.GetNanoSeconds();
+}
+
+Time
+FlsHeader::GetSendTime() const
+{
+    return NanoSeconds(m_sendTime);
+}
+
+void
+FlsHeader::SetUnicast(bool unicast)
+{
+    m_flags = unicast ? (m_flags | FLS_HEADER_UNICAST) : (m_flags & ~FLS_HEADER_UNICAST);
+}
+
+bool
+FlsHeader::IsUnicast() const
+{
+    return m_flags & FLS_HEADER_UNICAST;
+}
+
+} // namespace ns3
@@ -0,0 +1,50 @@
+#ifndef FLS_HEADER_H
+#define FLS_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <ostream>
+
+namespace ns3
+{
+
+// Application header at the start of every FLSApplication payload: source node, per
+// source sequence number and send time, for one-way latency and loss accounting. It
+// takes SERIALIZED_SIZE bytes of the traced packet size, so packets only grow if the
+// trace asks for less.
+class FlsHeader : public Header
+{
+  public:
+    static constexpr uint32_t SERIALIZED_SIZE = 20;
+
+    static TypeId GetTypeId(void);
+    TypeId GetInstanceTypeId(void) const override;
+
+    FlsHeader();
+
+    uint32_t GetSerializedSize(void) const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    void Print(std::ostream& os) const override;
+
+    void SetSource(uint32_t source);
+    uint32_t GetSource() const;
+    void SetSequence(uint32_t sequence);
+    uint32_t GetSequence() const;
+    void SetSendTime(Time sendTime);
+    Time GetSendTime() const;
+    void SetUnicast(bool unicast);
+    bool IsUnicast() const;
+
+  private:
+    uint32_t m_source;
+    uint32_t m_sequence;
+    int64_t m_sendTime; // nanoseconds
+    uint32_t m_flags;
+};
+
+} // namespace ns3
+
+#endif // FLS_HEADER_H
@@ -1,8 +1,24 @@
+#include "address-index.h"
+#include "animation-recorder.h"
+#include "app-statistics.h"
+#include "contact-plan.h"
+#include "contact-routing.h"
+#include "grid-wifi-channel.h"
+#include "hot-trace.h"
+#include "latency-histogram.h"
 #include "mobility-controller.h"
+#include "mobility-store.h"
 #include "options.h"
 #include "packet-trace.h"
+#include "phase-profiler.h"
+#include "position-sampler.h"
+#include "results-writer.h"
+#include "static-arp.h"
 #include "statistics-manager.h"
+#include "sweep.h"
+#include "trace-loader.h"
 #include "traffic-controller.h"
+#include "windowed-statistics.h"
 
 #include "ns3/aodv-module.h"
 #include "ns3/applications-module.h"
@@ -24,21 +40,10 @@
 
 #include <json/json.h>
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
-struct PacketInfo
-{
-    uint32_t packetId;
-    double sendTime;
-    double receiveTime;
-    uint32_t size;
-    uint32_t destinationNode;
-    bool received;
-};
-
-// 为每个节点存储发送的数据包信息
-std::map<uint32_t, std::vector<PacketInfo>> nodeSentPackets;
-
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("FLSSimulation");
@@ -107,57 +112,78 @@ PrintTrafficStatistics(NodeContainer& nodes)
               << " packets\n";
 }
 
-void
-IpTrace(const Ipv4Header& ipHeader, Ptr<const Packet> packet, uint32_t interface)
+// Application-layer totals of the swarm, for the run summary
+Json::Value
+GetTrafficTotals(NodeContainer& nodes)
 {
-    std::ostringstream oss;
-    packet->Print(oss);
-
-    // NS_LOG_INFO("IP Trace: " << Simulator::Now().GetSeconds() << "s\t"
-    //                          << "Interface: " << interface << "\tPacketID: " << packet->GetUid()
-    //                          << "\tSize: " << packet->GetSize() << "\tFrom: "
-    //                          << ipHeader.GetSource() << "\tTo: " << ipHeader.GetDestination()
-    //                          << "\tProtocol: " << (uint32_t)ipHeader.GetProtocol() << "\n"
-    //                          << oss.str());
+    FLSApplication::TrafficStats totals;
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<FLSApplication> app = DynamicCast<FLSApplication>(nodes.Get(i)->GetApplication(0));
+        if (app)
+        {
+            totals.sentPackets += app->GetStats().sentPackets;
+            totals.sentBytes += app->GetStats().sentBytes;
+            totals.receivedPackets += app->GetStats().receivedPackets;
+            totals.receivedBytes += app->GetStats().receivedBytes;
+        }
+    }
+
+    Json::Value traffic;
+    traffic["sentPackets"] = totals.sentPackets;
+    traffic["sentBytes"] = Json::UInt64(totals.sentBytes);
+    traffic["receivedPackets"] = totals.receivedPackets;
+    traffic["receivedBytes"] = Json::UInt64(totals.receivedBytes);
+    return traffic;
 }
 
+#ifdef FLS_HOT_TRACE
 void
-printNodePositions(NodeContainer nodes)
+IpTrace(HotTrace::Kind kind,
+        uint32_t node,
+        const Ipv4Header& ipHeader,
+        Ptr<const Packet> packet,
+        uint32_t interface)
 {
-    double now = Simulator::Now().GetSeconds();
-
-    NS_LOG_INFO("=== Node positions at " << now << " seconds ===");
+    HotTrace::Record(kind,
+                     node,
+                     packet->GetUid(),
+                     packet->GetSize() + ipHeader.GetSerializedSize());
+}
+#endif
 
-    for (NodeContainer::Iterator i = nodes.Begin(); i != nodes.End(); ++i)
+// Output file of a sweep point, "name-<point>.ext"; unchanged outside sweeps
+std::string
+GetPointFilename(const std::string& filename, const std::string& point)
+{
+    if (point.empty() || filename.empty())
     {
-        Ptr<Node> node = *i;
-        Ptr<MobilityModel> mobility = node->GetObject<MobilityModel>();
-        Vector pos = mobility->GetPosition();
-        NS_LOG_INFO("Node " << node->GetId() << " is at (" << pos.x << ", " << pos.y << ", "
-                            << pos.z << ")");
+        return filename;
     }
-
-    Simulator::Schedule(Seconds(0.1), &printNodePositions, nodes);
+    size_t dot = filename.find_last_of('.');
+    size_t slash = filename.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return filename + "-" + point;
+    }
+    return filename.substr(0, dot) + "-" + point + filename.substr(dot);
 }
 
-int
-main(int argc, char* argv[])
+// One simulation over the loaded traces. Its tables are added to results and its summary
+// to summary; output files get the point label of a sweep. Returns false if the
+// configuration is invalid.
+bool
+RunSimulation(const SimulationOptions& options,
+              const TraceLoader& traceLoader,
+              Ptr<ContactPlan>& contactPlan,
+              const std::string& point,
+              PhaseProfiler& profiler,
+              ResultsWriter& results,
+              Json::Value& summary)
 {
-    SimulationOptions options;
-    options.Parse(argc, argv);
-
-    LogComponentEnable("FLSSimulation", LOG_LEVEL_INFO);
-    LogComponentEnable("FLSApplication", LOG_LEVEL_INFO);
-    LogComponentEnable("SimulationOptions", LOG_LEVEL_INFO);
-    LogComponentEnable("TraceBasedMobilityModel", LOG_LEVEL_INFO);
-
-    Config::SetDefault("ns3::WifiRemoteStationManager::FragmentationThreshold",
-                       StringValue("2200"));
-    Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue("2200"));
-    Config::SetDefault("ns3::WifiMacQueue::MaxSize", QueueSizeValue(QueueSize("100p")));
-
-    std::string traceDir = "scratch/FLS/traces/";
     uint32_t nNodes = options.GetNumberOfNodes();
+    Ptr<MobilityStore> mobilityStore = traceLoader.GetMobilityStore();
+
     NodeContainer nodes;
     nodes.Create(nNodes);
 
@@ -168,24 +194,56 @@ main(int argc, char* argv[])
     MobilityHelper mobility;
 
     // Set initile position
-    mobility.SetMobilityModel("ns3::TraceBasedMobilityModel");
+    mobility.SetMobilityModel("ns3::TraceBasedMobilityModel",
+                              "PreInterpolate",
+                              BooleanValue(options.GetPreInterpolateMobility()));
     NS_LOG_INFO("Mobility model set.");
 
     mobility.Install(nodes);
     NS_LOG_INFO("Mobility installed on nodes.");
 
+    // The legacy mode re-reads loose text traces in double precision, as it always did
+    bool legacyFiles = options.GetPreInterpolateMobility() && options.GetScenarioBundle().empty();
     for (uint32_t i = 0; i < nNodes; ++i)
     {
         Ptr<TraceBasedMobilityModel> model = nodes.Get(i)->GetObject<TraceBasedMobilityModel>();
-        // std::string filename = traceDir + "trace_node_" + std::to_string(i) + ".txt";
-        std::string filename = traceDir + "trace_node_" + std::to_string(i);
-        NS_LOG_INFO("Loading trace for node " << i << " from file: " << filename);
-        model->LoadTrace(filename);
+        if (legacyFiles)
+        {
+            model->LoadTrace(traceLoader.GetMobilityTraceFilename(i));
+        }
+        else
+        {
+            model->SetTrace(mobilityStore, i);
+        }
     }
+    profiler.EndPhase("nodes");
 
-    // NS_LOG_INFO("Initial positions:");
-    Simulator::Schedule(Seconds(0.0), &printNodePositions, nodes);
-    // printNodePositions(nodes);
+    // Positions of the sampled nodes in a binary time series. The legacy pre-interpolated
+    // mode keeps per-model positions, so it is read node by node. Snapshots taken here
+    // are also reused by the animation at the same instants.
+    Ptr<PositionSampler> positionSampler;
+    if (!options.GetPositionFile().empty())
+    {
+        std::vector<uint32_t> sampled;
+        if (!PositionSampler::ParseNodes(options.GetPositionNodes(), nNodes, sampled))
+        {
+            NS_LOG_ERROR("Invalid node subset " << options.GetPositionNodes());
+            return false;
+        }
+        positionSampler = Create<PositionSampler>(
+            nodes,
+            options.GetPreInterpolateMobility() ? Ptr<MobilityStore>() : mobilityStore,
+            sampled,
+            Seconds(options.GetPositionInterval()));
+        if (positionSampler->Open(GetPointFilename(options.GetPositionFile(), point)))
+        {
+            Simulator::Schedule(Seconds(0.0), &PositionSampler::Start, positionSampler);
+        }
+        else
+        {
+            positionSampler = nullptr;
+        }
+    }
 
     int standard = 0;
     std::string wifiStandard = options.GetWifiStandard();
@@ -236,14 +294,17 @@ main(int argc, char* argv[])
 
     default:
         NS_LOG_ERROR("unknown wifi standard: " << wifiStandard);
-        return 1;
+        return false;
     }
 
     // Using Adhoc network
     WifiMacHelper wifiMac;
     wifiMac.SetType("ns3::AdhocWifiMac");
 
-    YansWifiPhyHelper wifiPhy;
+    // GridWifiPhy is a YansWifiPhy that hands its transmissions to a GridWifiChannel
+    YansWifiPhyHelper yansPhy;
+    GridWifiPhyHelper gridPhy;
+    YansWifiPhyHelper& wifiPhy = options.GetGridChannel() ? gridPhy : yansPhy;
     YansWifiChannelHelper wifiChannel;
 
     wifiPhy.Set("TxPowerStart", DoubleValue(options.GetTxPower()));
@@ -259,16 +320,64 @@ main(int argc, char* argv[])
     //                                DoubleValue(1.0),
     //                                "ReferenceLoss",
     //                                DoubleValue(50.0));
+    double maxRange = 1000.0;
     wifiChannel.AddPropagationLoss("ns3::RangePropagationLossModel",
                                    "MaxRange",
-                                   DoubleValue(1000.0));
-    wifiPhy.SetChannel(wifiChannel.Create());
+                                   DoubleValue(maxRange));
+
+    // Connectivity of the whole choreography at maxRange, shared by every run over it
+    if ((!options.GetContactPlan().empty() || options.GetContactRouting()) && !contactPlan)
+    {
+        if (!options.GetContactPlan().empty())
+        {
+            contactPlan = ContactPlan::Load(options.GetContactPlan(), *mobilityStore, maxRange);
+        }
+        if (!contactPlan)
+        {
+            contactPlan = ContactPlan::Compute(*mobilityStore, maxRange);
+            if (!options.GetContactPlan().empty())
+            {
+                contactPlan->Save(options.GetContactPlan());
+            }
+        }
+        std::vector<uint32_t> neighbors;
+        contactPlan->GetNeighbors(0, Seconds(0), neighbors);
+        NS_LOG_INFO("Contact plan: " << contactPlan->GetContacts().size()
+                                     << " contacts, node 0 has " << neighbors.size()
+                                     << " neighbors at 0 s, first change at "
+                                     << contactPlan->GetNextChange(Seconds(0)).GetSeconds()
+                                     << " s");
+    }
+
+    if (options.GetGridChannel())
+    {
+        // Same models on a channel that skips the PHYs out of reach of the sender
+        Ptr<GridWifiChannel> channel = CreateObject<GridWifiChannel>();
+        channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+        Ptr<RangePropagationLossModel> loss = CreateObject<RangePropagationLossModel>();
+        loss->SetAttribute("MaxRange", DoubleValue(maxRange));
+        channel->SetPropagationLossModel(loss);
+        // Legacy positions jump between interpolation steps, there the grid is rebuilt
+        // at every new transmission time instead
+        if (!options.GetPreInterpolateMobility())
+        {
+            double maxSpeed = mobilityStore->GetMaxSpeed();
+            NS_LOG_INFO("Grid channel enabled, maximum node speed " << maxSpeed << " m/s");
+            channel->SetAttribute("MaxSpeed", DoubleValue(maxSpeed));
+        }
+        wifiPhy.SetChannel(channel);
+    }
+    else
+    {
+        wifiPhy.SetChannel(wifiChannel.Create());
+    }
     // wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
 
     // PHY Setting
     wifiPhy.Set("RxNoiseFigure", DoubleValue(7.0));
 
     NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, nodes);
+    profiler.EndPhase("wifiInstall");
 
     // Install protocol stack
     InternetStackHelper internet;
@@ -277,31 +386,90 @@ main(int argc, char* argv[])
 
     internet.Install(nodes);
 
+    // Addresses of a previous sweep point are still registered
+    Ipv4AddressGenerator::Reset();
     Ipv4AddressHelper address;
-    address.SetBase("10.1.0.0", "255.255.254.0");
+    Ipv4Mask mask = AddressIndex::GetMask(nNodes);
+    address.SetBase(AddressIndex::GetNetwork(nNodes), mask);
     Ipv4InterfaceContainer interfaces = address.Assign(devices);
+    Ptr<AddressIndex> addressIndex = Create<AddressIndex>(interfaces, mask);
+
+    // Every address is on-link, resolve them all up front instead of by ARP broadcasts
+    Ptr<StaticArp> staticArp;
+    if (options.GetStaticArp())
+    {
+        staticArp = Create<StaticArp>(devices, interfaces);
+    }
+    profiler.EndPhase("internetInstall");
 
-    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    // Contact routing keeps multi-hop routes current as the swarm moves, global routing
+    // is computed once for the initial positions
+    Ptr<ContactRouting> contactRouting;
+    if (options.GetContactRouting())
+    {
+        contactRouting = Create<ContactRouting>(contactPlan, nodes, 1, options.GetLoaderThreads());
+        contactRouting->Start();
+    }
+    else
+    {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    }
 
     Ptr<OutputStreamWrapper> routingStream =
-        Create<OutputStreamWrapper>("routes.txt", std::ios::out);
+        Create<OutputStreamWrapper>(GetPointFilename("routes.txt", point), std::ios::out);
     Ipv4GlobalRoutingHelper::PrintRoutingTableAllAt(Seconds(0.0), routingStream); // 初始状态
     Ipv4GlobalRoutingHelper::PrintRoutingTableAllAt(Seconds(1.5), routingStream); // 应用启动后
     Ipv4GlobalRoutingHelper::PrintRoutingTableAllAt(Seconds(30.0), routingStream); // 运行一段时间后
+    profiler.EndPhase("routing");
 
     NS_LOG_INFO("Wi-Fi and Internet stack installed.");
 
-    // print each node's IP
-    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    // Every IPv4 packet in and out of a node, only in builds with the hot path trace
+    if (!options.GetHotTraceFile().empty())
+    {
+#ifdef FLS_HOT_TRACE
+        HotTrace::Open(GetPointFilename(options.GetHotTraceFile(), point));
+        for (uint32_t i = 0; i < nodes.GetN(); ++i)
+        {
+            Ptr<Ipv4> ipv4 = nodes.Get(i)->GetObject<Ipv4>();
+            if (ipv4)
+            {
+                ipv4->TraceConnectWithoutContext(
+                    "SendOutgoing",
+                    MakeBoundCallback(&IpTrace, HotTrace::IP_TX, i));
+                ipv4->TraceConnectWithoutContext(
+                    "LocalDeliver",
+                    MakeBoundCallback(&IpTrace, HotTrace::IP_RX, i));
+            }
+        }
+#else
+        NS_LOG_WARN("hotTraceFile ignored, hot path tracing needs a build with -DFLS_HOT_TRACE");
+#endif
+    }
+
+    // Per-node statistics every statsWindow, written out as the run goes
+    Ptr<WindowedStatistics> windowedStats;
+    if (!options.GetStatsFile().empty())
     {
-        Ptr<Ipv4> ipv4 = nodes.Get(i)->GetObject<Ipv4>();
-        if (ipv4)
+        windowedStats =
+            Create<WindowedStatistics>(nNodes, Seconds(options.GetStatsWindow()), Seconds(1.0));
+        if (windowedStats->Open(GetPointFilename(options.GetStatsFile(), point)))
+        {
+            Simulator::Schedule(Seconds(0.0), &WindowedStatistics::Start, windowedStats);
+        }
+        else
         {
-            ipv4->TraceConnectWithoutContext("SendOutgoing", MakeCallback(&IpTrace));
-            ipv4->TraceConnectWithoutContext("LocalDeliver", MakeCallback(&IpTrace));
+            windowedStats = nullptr;
         }
     }
 
+    // Without FlowMonitor the per-node statistics come from the applications
+    Ptr<AppStatistics> appStats;
+    if (!options.GetFlowMonitor())
+    {
+        appStats = Create<AppStatistics>(nNodes);
+    }
+
     // int port = 9;
     ApplicationContainer flsApps;
     for (uint32_t i = 0; i < nNodes; ++i)
@@ -310,108 +478,417 @@ main(int argc, char* argv[])
         nodes.Get(i)->AddApplication(app);
         app->SetStartTime(Seconds(1.0));
         app->SetStopTime(Seconds(30.0));
-        // loading packet trace file
-        // std::string traceFilename = traceDir + "packet_trace_node_" + std::to_string(i) + ".txt";
-        std::string traceFilename = traceDir + "packet_trace_node_" + std::to_string(i);
-        app->SetupTraceFile(traceFilename);
+        app->SetPacketTraces(traceLoader.GetPacketTraces(i));
+        app->SetAddressIndex(addressIndex);
+        app->SetStatistics(windowedStats);
+        app->SetAppStatistics(appStats);
         flsApps.Add(app);
     }
 
     NS_LOG_INFO("FLS application installed");
 
+    // FlowMonitor hooks the IPv4 stack of every node, keep it for validation runs
     FlowMonitorHelper flowmon;
-    Ptr<FlowMonitor> monitor = flowmon.InstallAll();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+    Ptr<FlowMonitor> monitor;
+    Ptr<Ipv4FlowClassifier> classifier;
     StatisticsManager statistics;
-    statistics.Setup(monitor, classifier);
+    if (options.GetFlowMonitor())
+    {
+        monitor = flowmon.InstallAll();
+        classifier = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+        statistics.Setup(monitor, classifier, addressIndex);
+    }
+    else
+    {
+        statistics.Setup(appStats);
+    }
+
+    profiler.EndPhase("applications");
 
     NS_LOG_INFO("Simulation started");
     Simulator::Stop(Seconds(30.0));
 
-    AnimationInterface anim("fls-animation.xml");
-    anim.EnablePacketMetadata(true);
-
-    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    // Decimated positions and sampled packets in a binary stream, or the full NetAnim
+    // XML trace with per-packet metadata for the runs that still need it
+    Ptr<AnimationRecorder> animation;
+    std::unique_ptr<AnimationInterface> anim;
+    if (options.GetAnimation() == "binary")
     {
-        anim.UpdateNodeColor(nodes.Get(i), 255, 0, 0);
-        anim.UpdateNodeSize(nodes.Get(i)->GetId(), 5, 5);
+        animation = Create<AnimationRecorder>(
+            nodes,
+            options.GetPreInterpolateMobility() ? Ptr<MobilityStore>() : mobilityStore,
+            Seconds(options.GetAnimationInterval()),
+            options.GetAnimationPacketSampling());
+        if (animation->Open(GetPointFilename(options.GetAnimationFile(), point)))
+        {
+            Simulator::Schedule(Seconds(0.0), &AnimationRecorder::Start, animation);
+        }
+        else
+        {
+            animation = nullptr;
+        }
     }
+    else if (options.GetAnimation() == "netanim")
+    {
+        anim = std::make_unique<AnimationInterface>(
+            GetPointFilename("fls-animation.xml", point));
+        anim->EnablePacketMetadata(true);
 
-    anim.SetMobilityPollInterval(Seconds(0.1));
+        for (uint32_t i = 0; i < nodes.GetN(); ++i)
+        {
+            anim->UpdateNodeColor(nodes.Get(i), 255, 0, 0);
+            anim->UpdateNodeSize(nodes.Get(i)->GetId(), 5, 5);
+        }
+
+        anim->SetMobilityPollInterval(Seconds(options.GetAnimationInterval()));
+    }
 
     for (uint32_t i = 0; i < nodes.GetN(); ++i)
     {
-        Ptr<Ipv4> ipv4 = nodes.Get(i)->GetObject<Ipv4>();
-        Ipv4InterfaceAddress iaddr = ipv4->GetAddress(1, 0);
-        NS_LOG_INFO("Node " << i << " has IP address: " << iaddr.GetLocal());
+        NS_LOG_INFO("Node " << i << " has IP address: " << addressIndex->GetAddress(i));
     }
+    profiler.EndPhase("netanim");
+
     Simulator::Run();
+    profiler.EndSimulationPhase("run");
 
-    PrintTrafficStatistics(nodes);
+    if (animation)
+    {
+        animation->Finish();
+    }
+    HotTrace::Close();
+    if (positionSampler)
+    {
+        positionSampler->Finish();
+    }
 
-    Json::Value results;
-    Json::Value flowStats(Json::arrayValue);
+    if (windowedStats)
+    {
+        windowedStats->Finish();
+        windowedStats->PrintSummary(std::cout);
+    }
+    else
+    {
+        PrintTrafficStatistics(nodes);
+    }
+    if (staticArp)
+    {
+        NS_LOG_INFO("Static ARP: " << staticArp->GetNAvoidedFrames() << " ARP frames avoided");
+    }
+    if (contactRouting)
+    {
+        NS_LOG_INFO("Contact routing: " << contactRouting->GetNUpdates() << " updates, "
+                                        << contactRouting->GetNRecomputedTrees()
+                                        << " trees recomputed, "
+                                        << contactRouting->GetNRouteChanges()
+                                        << " route changes");
+    }
 
-    monitor->CheckForLostPackets();
     statistics.CollectStatistics();
     statistics.PrintStats();
 
-    std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
-
-    // 打印统计信息
-    for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin();
-         i != stats.end();
-         ++i)
-    {
-        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(i->first);
-
-        // Json::Value flow;
-        // flow["flowId"] = i->first;
-        // flow["sourceAddress"] = t.sourceAddress.Get();
-        // flow["destinationAddress"] = t.destinationAddress.Get();
-        // flow["txPackets"] = i->second.txPackets;     // 发送的数据包数
-        // flow["rxPackets"] = i->second.rxPackets;     // 接收的数据包数
-        // flow["lostPackets"] = i->second.lostPackets; // 丢失的数据包数
-
-        // // 计算吞吐量（Mbps）
-        // flow["throughput"] =
-        //     i->second.rxBytes * 8.0 /
-        //     (i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds())
-        //     / 1000000;
-
-        // // 计算平均延迟（毫秒）
-        // flow["delay"] = i->second.delaySum.GetSeconds() / i->second.rxPackets * 1000;
-
-        // // 将流信息添加到数组
-        // flowStats.append(flow);
-
-        std::cout << "Flow " << i->first << " (" << t.sourceAddress << " -> "
-                  << t.destinationAddress << ")\n";
-        std::cout << "  Tx Packets: " << i->second.txPackets << "\n";
-        std::cout << "  Rx Packets: " << i->second.rxPackets << "\n";
-        std::cout << "  Lost Packets: " << i->second.lostPackets << "\n";
-        std::cout << "  Packet Loss Ratio: "
-                  << ((double)i->second.lostPackets / (double)i->second.txPackets) * 100 << "%\n";
-        std::cout << "  Throughput: "
-                  << i->second.rxBytes * 8.0 /
-                         (i->second.timeLastRxPacket.GetSeconds() -
-                          i->second.timeFirstTxPacket.GetSeconds()) /
-                         1000000
-                  << " Mbps\n";
-        std::cout << "  Mean Delay: "
-                  << i->second.delaySum.GetSeconds() / i->second.rxPackets * 1000 << " ms\n";
-        std::cout << "  Mean Jitter: "
-                  << i->second.jitterSum.GetSeconds() / (i->second.rxPackets - 1) * 1000 << "ms\n";
-        std::cout << "\n";
-    }
-
-    results["flowStats"] = flowStats;
+    profiler.EndPhase("statistics");
 
-    std::ofstream resultFile("simulation-results.json");
-    resultFile << results;
-    resultFile.close();
+    statistics.AddNodeTable(results);
+
+    std::map<FlowId, FlowMonitor::FlowStats> stats;
+    if (monitor)
+    {
+        stats = monitor->GetFlowStats();
+    }
+
+    // Per-flow statistics, as columns rather than one stdout block per flow
+    std::vector<uint32_t> flowId;
+    std::vector<uint32_t> sourceNode;
+    std::vector<uint32_t> destinationNode;
+    std::vector<uint32_t> sourceAddress;
+    std::vector<uint32_t> destinationAddress;
+    std::vector<uint32_t> sourcePort;
+    std::vector<uint32_t> destinationPort;
+    std::vector<uint32_t> protocol;
+    std::vector<uint32_t> flowTxPackets;
+    std::vector<uint32_t> flowRxPackets;
+    std::vector<uint32_t> flowLostPackets;
+    std::vector<uint64_t> flowTxBytes;
+    std::vector<uint64_t> flowRxBytes;
+    std::vector<int64_t> delaySum;
+    std::vector<int64_t> jitterSum;
+    std::vector<int64_t> timeFirstTx;
+    std::vector<int64_t> timeLastRx;
+    for (const auto& flow : stats)
+    {
+        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flow.first);
+        flowId.push_back(flow.first);
+        sourceNode.push_back(addressIndex->GetNode(t.sourceAddress));
+        destinationNode.push_back(addressIndex->GetNode(t.destinationAddress));
+        sourceAddress.push_back(t.sourceAddress.Get());
+        destinationAddress.push_back(t.destinationAddress.Get());
+        sourcePort.push_back(t.sourcePort);
+        destinationPort.push_back(t.destinationPort);
+        protocol.push_back(t.protocol);
+        flowTxPackets.push_back(flow.second.txPackets);
+        flowRxPackets.push_back(flow.second.rxPackets);
+        flowLostPackets.push_back(flow.second.lostPackets);
+        flowTxBytes.push_back(flow.second.txBytes);
+        flowRxBytes.push_back(flow.second.rxBytes);
+        delaySum.push_back(flow.second.delaySum.GetNanoSeconds());
+        jitterSum.push_back(flow.second.jitterSum.GetNanoSeconds());
+        timeFirstTx.push_back(flow.second.timeFirstTxPacket.GetNanoSeconds());
+        timeLastRx.push_back(flow.second.timeLastRxPacket.GetNanoSeconds());
+    }
+    results.BeginTable("flows", flowId.size());
+    results.AddColumn("flowId", flowId);
+    results.AddColumn("sourceNode", sourceNode);
+    results.AddColumn("destinationNode", destinationNode);
+    results.AddColumn("sourceAddress", sourceAddress);
+    results.AddColumn("destinationAddress", destinationAddress);
+    results.AddColumn("sourcePort", sourcePort);
+    results.AddColumn("destinationPort", destinationPort);
+    results.AddColumn("protocol", protocol);
+    results.AddColumn("txPackets", flowTxPackets);
+    results.AddColumn("rxPackets", flowRxPackets);
+    results.AddColumn("lostPackets", flowLostPackets);
+    results.AddColumn("txBytes", flowTxBytes);
+    results.AddColumn("rxBytes", flowRxBytes);
+    results.AddColumn("delaySumNs", delaySum);
+    results.AddColumn("jitterSumNs", jitterSum);
+    results.AddColumn("timeFirstTxNs", timeFirstTx);
+    results.AddColumn("timeLastRxNs", timeLastRx);
+
+    // One-way application latencies, per receiving node and merged over the swarm. The
+    // non-empty buckets are kept so that histograms of several runs can be merged.
+    LatencyHistogram swarmLatency;
+    std::vector<uint32_t> latencyNode;
+    std::vector<uint64_t> latencyCount;
+    std::vector<int64_t> p50;
+    std::vector<int64_t> p90;
+    std::vector<int64_t> p99;
+    std::vector<int64_t> p999;
+    std::vector<int64_t> latencyMax;
+    std::vector<uint32_t> bucketNode;
+    std::vector<uint32_t> bucketIndex;
+    std::vector<uint64_t> bucketCount;
+    for (uint32_t i = 0; i < nNodes; ++i)
+    {
+        const LatencyHistogram& latency =
+            DynamicCast<FLSApplication>(flsApps.Get(i))->GetLatency();
+        swarmLatency.Merge(latency);
+        latencyNode.push_back(i);
+        latencyCount.push_back(latency.GetCount());
+        p50.push_back(latency.GetPercentile(50).GetNanoSeconds());
+        p90.push_back(latency.GetPercentile(90).GetNanoSeconds());
+        p99.push_back(latency.GetPercentile(99).GetNanoSeconds());
+        p999.push_back(latency.GetPercentile(99.9).GetNanoSeconds());
+        latencyMax.push_back(latency.GetMax().GetNanoSeconds());
+        const std::vector<uint64_t>& counts = latency.GetBucketCounts();
+        for (uint32_t bucket = 0; bucket < counts.size(); ++bucket)
+        {
+            if (counts[bucket] > 0)
+            {
+                bucketNode.push_back(i);
+                bucketIndex.push_back(bucket);
+                bucketCount.push_back(counts[bucket]);
+            }
+        }
+    }
+    results.BeginTable("latency", latencyNode.size());
+    results.AddColumn("nodeId", latencyNode);
+    results.AddColumn("count", latencyCount);
+    results.AddColumn("p50Ns", p50);
+    results.AddColumn("p90Ns", p90);
+    results.AddColumn("p99Ns", p99);
+    results.AddColumn("p999Ns", p999);
+    results.AddColumn("maxNs", latencyMax);
+    results.BeginTable("latencyBuckets", bucketNode.size());
+    results.AddColumn("nodeId", bucketNode);
+    results.AddColumn("bucket", bucketIndex);
+    results.AddColumn("count", bucketCount);
+
+    std::cout << "Latency over " << swarmLatency.GetCount()
+              << " packets: p50 " << swarmLatency.GetPercentile(50).GetSeconds() * 1000
+              << " ms, p99 " << swarmLatency.GetPercentile(99).GetSeconds() * 1000
+              << " ms, p99.9 " << swarmLatency.GetPercentile(99.9).GetSeconds() * 1000
+              << " ms, max " << swarmLatency.GetMax().GetSeconds() * 1000 << " ms\n";
+
+    summary["statistics"] = statistics.GenerateJsonReport();
+    summary["traffic"] = GetTrafficTotals(nodes);
+    summary["latency"] = swarmLatency.ToJson();
+    summary["flows"] = static_cast<uint32_t>(stats.size());
 
     Simulator::Destroy();
+    profiler.EndPhase("destroy");
+    return true;
+}
+
+// Options of a command line held as strings, such as the one of a sweep point
+void
+ParseArguments(std::vector<std::string> arguments, SimulationOptions& options)
+{
+    std::vector<char*> argv;
+    for (std::string& argument : arguments)
+    {
+        argv.push_back(argument.data());
+    }
+    options.Parse(argv.size(), argv.data());
+}
+
+// Binary results and the small summary next to them. A sweep writes them after every
+// point, so that the points already run are kept if a later one fails.
+void
+WriteResults(const SimulationOptions& options, const ResultsWriter& results, Json::Value summary)
+{
+    if (results.Write(options.GetResultsFile()))
+    {
+        NS_LOG_INFO("Results written to " << options.GetResultsFile());
+    }
+
+    // The RNG run identifies replications
+    summary["rngRun"] = Json::UInt64(RngSeedManager::GetRun());
+    summary["resultsFile"] = options.GetResultsFile();
+    std::ofstream resultFile("simulation-results.json");
+    resultFile << summary;
+}
+
+int
+main(int argc, char* argv[])
+{
+    // Wall-clock time and peak memory of every phase of the run
+    PhaseProfiler profiler;
+
+    SimulationOptions options;
+    options.Parse(argc, argv);
+
+    LogComponentEnable("FLSSimulation", LOG_LEVEL_INFO);
+    LogComponentEnable("FLSApplication", LOG_LEVEL_INFO);
+    LogComponentEnable("SimulationOptions", LOG_LEVEL_INFO);
+    LogComponentEnable("TraceBasedMobilityModel", LOG_LEVEL_INFO);
+    LogComponentEnable("MobilityStore", LOG_LEVEL_INFO);
+    LogComponentEnable("TraceLoader", LOG_LEVEL_INFO);
+    LogComponentEnable("PacketTraceStream", LOG_LEVEL_INFO);
+    LogComponentEnable("GridWifiChannel", LOG_LEVEL_INFO);
+    LogComponentEnable("ContactPlan", LOG_LEVEL_INFO);
+    LogComponentEnable("ContactRouting", LOG_LEVEL_INFO);
+    LogComponentEnable("StaticArp", LOG_LEVEL_INFO);
+    LogComponentEnable("AddressIndex", LOG_LEVEL_INFO);
+    LogComponentEnable("WindowedStatistics", LOG_LEVEL_INFO);
+    LogComponentEnable("PhaseProfiler", LOG_LEVEL_INFO);
+    LogComponentEnable("AnimationRecorder", LOG_LEVEL_INFO);
+    LogComponentEnable("HotTrace", LOG_LEVEL_INFO);
+    LogComponentEnable("PositionSampler", LOG_LEVEL_INFO);
+    LogComponentEnable("Sweep", LOG_LEVEL_INFO);
+
+    Config::SetDefault("ns3::WifiRemoteStationManager::FragmentationThreshold",
+                       StringValue("2200"));
+    Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue("2200"));
+    Config::SetDefault("ns3::WifiMacQueue::MaxSize", QueueSizeValue(QueueSize("100p")));
+
+    // Every point of a sweep is checked before the traces are loaded, rather than stopping
+    // the sweep after the points before it have run
+    Sweep sweep;
+    std::vector<std::vector<std::string>> pointArguments;
+    if (options.GetSweep().empty())
+    {
+        if (!options.Validate())
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        if (!sweep.Load(options.GetSweep()))
+        {
+            return 1;
+        }
+        for (uint32_t point = 0; point < sweep.GetNPoints(); ++point)
+        {
+            // The command line of the sweep, then the settings of the point
+            std::vector<std::string> arguments(argv, argv + argc);
+            for (const std::string& argument : sweep.GetArguments(point))
+            {
+                arguments.push_back(argument);
+            }
+            SimulationOptions pointOptions;
+            ParseArguments(arguments, pointOptions);
+            if (!pointOptions.Validate())
+            {
+                NS_LOG_ERROR("Invalid sweep point " << point);
+                return 1;
+            }
+            pointArguments.push_back(arguments);
+        }
+    }
+
+    std::string traceDir = options.GetTraceDir();
+    uint32_t nNodes = options.GetNumberOfNodes();
+
+    // Parse every mobility and packet trace up front on a thread pool, or map them from a
+    // scenario bundle. All keyframes of the swarm live in one shared store, each model
+    // only keeps its index.
+    TraceLoader traceLoader(traceDir, nNodes);
+    traceLoader.SetPacketTraceWindow(options.GetPacketWindow());
+    bool loaded = options.GetScenarioBundle().empty()
+                      ? traceLoader.Load(options.GetLoaderThreads())
+                      : traceLoader.LoadBundle(options.GetScenarioBundle());
+    if (!loaded)
+    {
+        return 1;
+    }
+    Ptr<MobilityStore> mobilityStore = traceLoader.GetMobilityStore();
+    NS_LOG_INFO("Mobility store holds " << mobilityStore->GetMemoryUsage()
+                                        << " bytes of keyframes");
+    profiler.EndPhase("traceLoading");
+
+    // Traces are loaded once, every point of a sweep rebuilds the network over them
+    Ptr<ContactPlan> contactPlan;
+    ResultsWriter results;
+    Json::Value summary;
+    if (options.GetSweep().empty())
+    {
+        if (!RunSimulation(options, traceLoader, contactPlan, "", profiler, results, summary))
+        {
+            return 1;
+        }
+        WriteResults(options, results, summary);
+        profiler.EndPhase("output");
+    }
+    else
+    {
+        summary["sweep"] = options.GetSweep();
+        summary["points"] = Json::Value(Json::arrayValue);
+        for (uint32_t point = 0; point < sweep.GetNPoints(); ++point)
+        {
+            NS_LOG_INFO("Sweep point " << point + 1 << " of " << sweep.GetNPoints());
+            SimulationOptions pointOptions;
+            ParseArguments(pointArguments[point], pointOptions);
+
+            PhaseProfiler pointProfiler;
+            Json::Value pointSummary;
+            std::string label = std::to_string(point);
+            results.SetTableSuffix("@" + label);
+            if (!RunSimulation(pointOptions,
+                               traceLoader,
+                               contactPlan,
+                               label,
+                               pointProfiler,
+                               results,
+                               pointSummary))
+            {
+                return 1;
+            }
+            pointSummary["point"] = point;
+            pointSummary["settings"] = sweep.GetSettings(point);
+            pointSummary["profile"] = pointProfiler.ToJson();
+            summary["points"].append(pointSummary);
+            WriteResults(options, results, summary);
+        }
+        profiler.EndPhase("sweep");
+    }
+
+    profiler.Print(std::cout);
+    if (!options.GetProfileFile().empty())
+    {
+        profiler.Write(options.GetProfileFile());
+    }
     NS_LOG_INFO("Simulation completed successfully");
 
     return 0;
@@ -0,0 +1,310 @@
+#include "grid-wifi-channel.h"
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-ppdu.h"
+#include "ns3/wifi-utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("GridWifiChannel");
+
+NS_OBJECT_ENSURE_REGISTERED(GridWifiChannel);
+NS_OBJECT_ENSURE_REGISTERED(GridWifiPhy);
+
+TypeId
+GridWifiChannel::GetTypeId(void)
+{
+    static TypeId tid =
+        TypeId("ns3::GridWifiChannel")
+            .SetParent<YansWifiChannel>()
+            .SetGroupName("FLS")
+            .AddConstructor<GridWifiChannel>()
+            .AddAttribute("MaxSpeed",
+                          "Upper bound on the speed of every node in m/s. A negative value "
+                          "rebuilds the grid whenever the simulation time has advanced.",
+                          DoubleValue(-1.0),
+                          MakeDoubleAccessor(&GridWifiChannel::m_maxSpeed),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("RebuildSlack",
+                          "Distance in meters nodes may have moved before the grid is rebuilt",
+                          DoubleValue(10.0),
+                          MakeDoubleAccessor(&GridWifiChannel::m_rebuildSlack),
+                          MakeDoubleChecker<double>(0.0));
+    return tid;
+}
+
+GridWifiChannel::GridWifiChannel()
+    : m_maxSpeed(-1.0),
+      m_rebuildSlack(10.0),
+      m_minSensitivityDbm(0),
+      m_hasGrid(false),
+      m_cellSize(0)
+{
+}
+
+void
+GridWifiChannel::SetPropagationLossModel(const Ptr<PropagationLossModel> loss)
+{
+    YansWifiChannel::SetPropagationLossModel(loss);
+    m_loss = loss;
+    m_maxRange.clear();
+}
+
+void
+GridWifiChannel::SetPropagationDelayModel(const Ptr<PropagationDelayModel> delay)
+{
+    YansWifiChannel::SetPropagationDelayModel(delay);
+    m_delay = delay;
+}
+
+void
+GridWifiChannel::UpdatePhys()
+{
+    // The base class keeps its PHY list private, recover it through the devices
+    m_phys.clear();
+    m_mobility.clear();
+    m_minSensitivityDbm = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < GetNDevices(); ++i)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(GetDevice(i));
+        NS_ASSERT_MSG(device, "GridWifiChannel requires PHYs attached to a WifiNetDevice");
+        Ptr<YansWifiPhy> phy = DynamicCast<YansWifiPhy>(device->GetPhy());
+        m_phys.push_back(phy);
+        m_mobility.push_back(phy->GetMobility());
+        m_minSensitivityDbm =
+            std::min(m_minSensitivityDbm, phy->GetRxSensitivity() - phy->GetRxGain());
+    }
+    m_maxRange.clear();
+    m_hasGrid = false;
+}
+
+double
+GridWifiChannel::GetMaxRange(double txPowerDbm)
+{
+    if (m_phys.size() != GetNDevices())
+    {
+        UpdatePhys();
+    }
+    auto it = m_maxRange.find(txPowerDbm);
+    if (it != m_maxRange.end())
+    {
+        return it->second;
+    }
+
+    // The loss does not increase with distance: double until nothing can be received,
+    // then bisect. Everything beyond the upper bound is below every PHY's sensitivity.
+    Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition(Vector(0, 0, 0));
+    auto isReceivable = [&](double distance) {
+        b->SetPosition(Vector(distance, 0, 0));
+        return m_loss->CalcRxPower(txPowerDbm, a, b) >= m_minSensitivityDbm;
+    };
+
+    const double limit = 1e7;
+    double range = std::numeric_limits<double>::infinity();
+    double lo = 0;
+    double hi = 1;
+    while (hi <= limit && isReceivable(hi))
+    {
+        lo = hi;
+        hi *= 2;
+    }
+    if (hi <= limit)
+    {
+        for (int i = 0; i < 64 && hi - lo > 1e-6; ++i)
+        {
+            double mid = (lo + hi) / 2;
+            (isReceivable(mid) ? lo : hi) = mid;
+        }
+        range = hi * (1 + 1e-9);
+    }
+
+    NS_LOG_INFO("Maximum range at " << txPowerDbm << " dBm: " << range << " m");
+    m_maxRange[txPowerDbm] = range;
+    return range;
+}
+
+uint64_t
+GridWifiChannel::GetCellKey(int64_t x, int64_t y, int64_t z) const
+{
+    // 21 bits per axis, enough for +-1e6 cells
+    const int64_t offset = int64_t(1) << 20;
+    auto bits = [offset](int64_t c) {
+        return static_cast<uint64_t>(std::clamp<int64_t>(c + offset, 0, 2 * offset - 1));
+    };
+    return (bits(x) << 42) | (bits(y) << 21) | bits(z);
+}
+
+void
+GridWifiChannel::BuildGrid()
+{
+    m_grid.clear();
+    for (uint32_t i = 0; i < m_phys.size(); ++i)
+    {
+        Vector p = m_mobility[i]->GetPosition();
+        m_grid.emplace_back(GetCellKey(std::floor(p.x / m_cellSize),
+                                       std::floor(p.y / m_cellSize),
+                                       std::floor(p.z / m_cellSize)),
+                            i);
+    }
+    std::sort(m_grid.begin(), m_grid.end());
+    m_gridTime = Simulator::Now();
+    m_hasGrid = true;
+}
+
+void
+GridWifiChannel::FindCandidates(const Vector& position, double radius)
+{
+    m_candidates.clear();
+    int64_t x0 = std::floor((position.x - radius) / m_cellSize);
+    int64_t x1 = std::floor((position.x + radius) / m_cellSize);
+    int64_t y0 = std::floor((position.y - radius) / m_cellSize);
+    int64_t y1 = std::floor((position.y + radius) / m_cellSize);
+    int64_t z0 = std::floor((position.z - radius) / m_cellSize);
+    int64_t z1 = std::floor((position.z + radius) / m_cellSize);
+    for (int64_t x = x0; x <= x1; ++x)
+    {
+        for (int64_t y = y0; y <= y1; ++y)
+        {
+            for (int64_t z = z0; z <= z1; ++z)
+            {
+                uint64_t key = GetCellKey(x, y, z);
+                auto it = std::lower_bound(m_grid.begin(),
+                                           m_grid.end(),
+                                           std::make_pair(key, uint32_t(0)));
+                for (; it != m_grid.end() && it->first == key; ++it)
+                {
+                    m_candidates.push_back(it->second);
+                }
+            }
+        }
+    }
+    // Same order as the full scan, so simultaneous receptions are scheduled identically
+    std::sort(m_candidates.begin(), m_candidates.end());
+}
+
+void
+GridWifiChannel::Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm)
+{
+    NS_LOG_FUNCTION(this << sender << ppdu << txPowerDbm);
+    Ptr<MobilityModel> senderMobility = sender->GetMobility();
+    NS_ASSERT(senderMobility);
+
+    double range = GetMaxRange(txPowerDbm);
+    if (std::isinf(range))
+    {
+        // No cut-off distance, fall back to visiting every PHY
+        m_candidates.resize(m_phys.size());
+        for (uint32_t i = 0; i < m_phys.size(); ++i)
+        {
+            m_candidates[i] = i;
+        }
+    }
+    else
+    {
+        Time now = Simulator::Now();
+        double elapsed = (now - m_gridTime).GetSeconds();
+        bool stale = (m_maxSpeed < 0) ? now != m_gridTime : m_maxSpeed * elapsed > m_rebuildSlack;
+        if (!m_hasGrid || stale)
+        {
+            m_cellSize = std::max(m_cellSize, range + m_rebuildSlack);
+            BuildGrid();
+            elapsed = 0;
+        }
+        // Receivers may have moved away from their cell by at most MaxSpeed * elapsed
+        double drift = (m_maxSpeed < 0) ? 0 : m_maxSpeed * elapsed;
+        FindCandidates(senderMobility->GetPosition(), range + drift);
+    }
+
+    for (uint32_t i : m_candidates)
+    {
+        Ptr<YansWifiPhy> phy = m_phys[i];
+        // For now don't account for inter channel interference nor channel bonding
+        if (phy == sender || phy->GetChannelNumber() != sender->GetChannelNumber())
+        {
+            continue;
+        }
+
+        Ptr<MobilityModel> receiverMobility = m_mobility[i];
+        double rxPowerDbm = m_loss->CalcRxPower(txPowerDbm, senderMobility, receiverMobility);
+        // YansWifiChannel schedules these as well, only for Receive() to drop them
+        if (!IsAboveSensitivity(phy, ppdu, rxPowerDbm))
+        {
+            continue;
+        }
+        Time delay = m_delay->GetDelay(senderMobility, receiverMobility);
+
+        Ptr<NetDevice> dstNetDevice = phy->GetDevice();
+        uint32_t dstNode = dstNetDevice ? dstNetDevice->GetNode()->GetId() : 0xffffffff;
+        Simulator::ScheduleWithContext(dstNode,
+                                       delay,
+                                       &GridWifiChannel::Receive,
+                                       phy,
+                                       ppdu->Copy(),
+                                       rxPowerDbm);
+    }
+}
+
+bool
+GridWifiChannel::IsAboveSensitivity(Ptr<YansWifiPhy> phy,
+                                    Ptr<const WifiPpdu> ppdu,
+                                    double rxPowerDbm)
+{
+    // Compare received TX power per MHz to normalized RX sensitivity
+    return rxPowerDbm + phy->GetRxGain() >=
+           phy->GetRxSensitivity() + RatioToDb(ppdu->GetTxChannelWidth() / 20.0);
+}
+
+void
+GridWifiChannel::Receive(Ptr<YansWifiPhy> phy, Ptr<const WifiPpdu> ppdu, double rxPowerDbm)
+{
+    NS_LOG_FUNCTION(phy << ppdu << rxPowerDbm);
+    RxPowerWattPerChannelBand rxPowerW;
+    rxPowerW.insert({phy->GetBand(ppdu->GetTxChannelWidth()),
+                     DbmToW(rxPowerDbm + phy->GetRxGain())});
+    phy->StartReceivePreamble(ppdu, rxPowerW, ppdu->GetTxDuration());
+}
+
+TypeId
+GridWifiPhy::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::GridWifiPhy")
+                            .SetParent<YansWifiPhy>()
+                            .SetGroupName("FLS")
+                            .AddConstructor<GridWifiPhy>();
+    return tid;
+}
+
+GridWifiPhy::GridWifiPhy()
+{
+}
+
+void
+GridWifiPhy::StartTx(Ptr<const WifiPpdu> ppdu)
+{
+    Ptr<GridWifiChannel> channel = DynamicCast<GridWifiChannel>(GetChannel());
+    if (!channel)
+    {
+        YansWifiPhy::StartTx(ppdu);
+        return;
+    }
+    NS_LOG_FUNCTION(this << ppdu);
+    channel->Send(this, ppdu, GetTxPowerForTransmission(ppdu) + GetTxGain());
+}
+
+GridWifiPhyHelper::GridWifiPhyHelper()
+{
+    m_phys.front().SetTypeId("ns3::GridWifiPhy");
+}
+
+} // namespace ns3
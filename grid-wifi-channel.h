@@ -0,0 +1,95 @@
+#ifndef GRID_WIFI_CHANNEL_H
+#define GRID_WIFI_CHANNEL_H
+
+#include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/yans-wifi-phy.h"
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+// YansWifiChannel that only evaluates the PHYs near the sender. Node positions are binned
+// into a uniform 3D grid, and a transmission only visits the cells within the largest
+// distance at which any PHY could still lock on, found from the loss model, the tx power
+// and the rx sensitivities. The grid is rebuilt once nodes may have moved more than
+// RebuildSlack, bounded by MaxSpeed. Delivery is identical to YansWifiChannel provided
+// the loss model is deterministic and does not increase with distance (e.g.
+// RangePropagationLossModel, Friis, LogDistance); PHYs are visited in the same order.
+//
+// YansWifiChannel::Send() is not virtual, so transmissions reach this channel through
+// GridWifiPhy, installed by GridWifiPhyHelper.
+class GridWifiChannel : public YansWifiChannel
+{
+  public:
+    static TypeId GetTypeId(void);
+    GridWifiChannel();
+
+    // Also keep the models here, the base class does not expose them
+    void SetPropagationLossModel(const Ptr<PropagationLossModel> loss);
+    void SetPropagationDelayModel(const Ptr<PropagationDelayModel> delay);
+
+    void Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm);
+
+    // Largest distance at which a txPowerDbm transmission can be received, infinite if the
+    // loss model never drops below the rx sensitivities
+    double GetMaxRange(double txPowerDbm);
+
+  private:
+    // Mirror of YansWifiChannel::Receive(), which is private
+    static void Receive(Ptr<YansWifiPhy> phy, Ptr<const WifiPpdu> ppdu, double rxPowerDbm);
+    static bool IsAboveSensitivity(Ptr<YansWifiPhy> phy,
+                                   Ptr<const WifiPpdu> ppdu,
+                                   double rxPowerDbm);
+
+    void UpdatePhys();
+    void BuildGrid();
+    uint64_t GetCellKey(int64_t x, int64_t y, int64_t z) const;
+    // Indices of the PHYs within radius of position according to the grid, ascending
+    void FindCandidates(const Vector& position, double radius);
+
+    Ptr<PropagationLossModel> m_loss;
+    Ptr<PropagationDelayModel> m_delay;
+    double m_maxSpeed;     // m/s, bound on the speed of every node
+    double m_rebuildSlack; // m, largest displacement tolerated before a rebuild
+
+    std::vector<Ptr<YansWifiPhy>> m_phys;
+    std::vector<Ptr<MobilityModel>> m_mobility;
+    double m_minSensitivityDbm; // lowest rx sensitivity minus rx gain over all PHYs
+    std::map<double, double> m_maxRange;
+
+    bool m_hasGrid;
+    Time m_gridTime;
+    double m_cellSize;
+    std::vector<std::pair<uint64_t, uint32_t>> m_grid; // (cell, phy index), sorted
+    std::vector<uint32_t> m_candidates;
+};
+
+// YansWifiPhy that sends through a GridWifiChannel when it is attached to one
+class GridWifiPhy : public YansWifiPhy
+{
+  public:
+    static TypeId GetTypeId(void);
+    GridWifiPhy();
+
+    void StartTx(Ptr<const WifiPpdu> ppdu) override;
+};
+
+// YansWifiPhyHelper creating GridWifiPhy instances
+class GridWifiPhyHelper : public YansWifiPhyHelper
+{
+  public:
+    GridWifiPhyHelper();
+};
+
+} // namespace ns3
+
+#endif // GRID_WIFI_CHANNEL_H
@@ -0,0 +1,155 @@
+#include "hot-trace.h"
+
+#include "ns3/log.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("HotTrace");
+
+namespace
+{
+struct HotTraceHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t eventSize;
+    uint32_t reserved;
+    uint64_t dropped;
+};
+
+static_assert(sizeof(HotTraceHeader) == 24, "HotTraceHeader must be 24 bytes");
+static_assert(sizeof(HotTrace::Event) == 24, "HotTrace events must be 24 bytes");
+
+const char HOT_TRACE_MAGIC[4] = {'F', 'L', 'S', 'H'};
+const uint32_t HOT_TRACE_VERSION = 1;
+} // namespace
+
+std::vector<HotTrace::Event>* HotTrace::s_current = nullptr;
+uint32_t HotTrace::s_chunkEvents = 0;
+uint64_t HotTrace::s_dropped = 0;
+bool HotTrace::s_open = false;
+std::ofstream HotTrace::s_file;
+std::vector<std::vector<HotTrace::Event>> HotTrace::s_chunks;
+std::deque<std::vector<HotTrace::Event>*> HotTrace::s_free;
+std::deque<std::vector<HotTrace::Event>*> HotTrace::s_full;
+bool HotTrace::s_closing = false;
+std::mutex HotTrace::s_mutex;
+std::condition_variable HotTrace::s_wakeup;
+std::thread HotTrace::s_writer;
+
+bool
+HotTrace::Open(const std::string& filename, uint32_t chunkEvents, uint32_t nChunks)
+{
+    NS_ASSERT(!s_open && chunkEvents > 0 && nChunks > 1);
+    s_file.open(filename, std::ios::binary);
+    if (!s_file)
+    {
+        NS_LOG_ERROR("Unable to write hot path trace " << filename);
+        return false;
+    }
+    HotTraceHeader header;
+    std::memcpy(header.magic, HOT_TRACE_MAGIC, 4);
+    header.version = HOT_TRACE_VERSION;
+    header.eventSize = sizeof(Event);
+    header.reserved = 0;
+    header.dropped = 0;
+    s_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    s_chunkEvents = chunkEvents;
+    s_chunks.assign(nChunks, std::vector<Event>());
+    for (std::vector<Event>& chunk : s_chunks)
+    {
+        chunk.reserve(chunkEvents);
+        s_free.push_back(&chunk);
+    }
+    s_dropped = 0;
+    s_closing = false;
+    s_open = true;
+    s_writer = std::thread(&HotTrace::Write);
+    NS_LOG_INFO("Hot path trace to " << filename << ", " << nChunks << " chunks of "
+                                     << chunkEvents << " events");
+    return true;
+}
+
+bool
+HotTrace::NextChunk()
+{
+    if (!s_open)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_current)
+    {
+        s_full.push_back(s_current);
+        s_current = nullptr;
+        s_wakeup.notify_one();
+    }
+    if (s_free.empty())
+    {
+        s_dropped++;
+        return false;
+    }
+    s_current = s_free.front();
+    s_free.pop_front();
+    return true;
+}
+
+void
+HotTrace::Write()
+{
+    std::unique_lock<std::mutex> lock(s_mutex);
+    while (true)
+    {
+        s_wakeup.wait(lock, [] { return s_closing || !s_full.empty(); });
+        if (s_full.empty())
+        {
+            return;
+        }
+        std::vector<Event>* chunk = s_full.front();
+        s_full.pop_front();
+        // The simulation keeps filling other chunks meanwhile
+        lock.unlock();
+        s_file.write(reinterpret_cast<const char*>(chunk->data()),
+                     chunk->size() * sizeof(Event));
+        chunk->clear();
+        lock.lock();
+        s_free.push_back(chunk);
+    }
+}
+
+void
+HotTrace::Close()
+{
+    if (!s_open)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_current)
+        {
+            s_full.push_back(s_current);
+            s_current = nullptr;
+        }
+        s_closing = true;
+        s_open = false;
+    }
+    s_wakeup.notify_one();
+    s_writer.join();
+
+    s_file.seekp(offsetof(HotTraceHeader, dropped));
+    s_file.write(reinterpret_cast<const char*>(&s_dropped), sizeof(s_dropped));
+    s_file.close();
+    s_free.clear();
+    s_chunks.clear();
+    if (s_dropped > 0)
+    {
+        NS_LOG_WARN("Hot path trace dropped " << s_dropped << " events, the writer fell behind");
+    }
+}
+
+} // namespace ns3
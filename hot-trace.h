@@ -0,0 +1,97 @@
+#ifndef HOT_TRACE_H
+#define HOT_TRACE_H
+
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Trace points on the per-packet path. They compile to nothing unless the simulation
+// is built with -DFLS_HOT_TRACE, so diagnostics cost nothing in normal runs.
+#ifdef FLS_HOT_TRACE
+#define FLS_HOT_TRACE_EVENT(kind, node, uid, size)                                          \
+    ns3::HotTrace::Record(ns3::HotTrace::kind, node, uid, size)
+#else
+#define FLS_HOT_TRACE_EVENT(kind, node, uid, size)
+#endif
+
+namespace ns3
+{
+
+// Fixed-size binary event records for one run, collected in a ring of chunks. The
+// simulation thread fills the current chunk; full chunks are written out by a
+// background thread. When the writer falls behind and no chunk is free, records are
+// dropped and counted rather than stalling the simulation.
+//
+// Trace dumps ("FLSH") hold a 24-byte header (magic, version, record size, dropped
+// record count) followed by 24-byte Event records in time order, decoded by
+// server/decode_hot_trace.py.
+class HotTrace
+{
+  public:
+    enum Kind : uint16_t
+    {
+        APP_TX = 0,
+        APP_RX = 1,
+        IP_TX = 2,
+        IP_RX = 3,
+    };
+
+    struct Event
+    {
+        int64_t time; // nanoseconds
+        uint64_t uid;
+        uint32_t node;
+        uint16_t kind;
+        uint16_t size;
+    };
+
+    // Starts recording to filename, chunkEvents records per chunk, nChunks in the ring
+    static bool Open(const std::string& filename,
+                     uint32_t chunkEvents = 65536,
+                     uint32_t nChunks = 8);
+    // Writes the remaining records and the dropped count, stops the writer
+    static void Close();
+
+    static void Record(Kind kind, uint32_t node, uint64_t uid, uint32_t size)
+    {
+        if ((!s_current || s_current->size() == s_chunkEvents) && !NextChunk())
+        {
+            return;
+        }
+        s_current->push_back(Event{Simulator::Now().GetNanoSeconds(),
+                                   uid,
+                                   node,
+                                   kind,
+                                   uint16_t(size < UINT16_MAX ? size : UINT16_MAX)});
+    }
+
+  private:
+    // Hands the full chunk to the writer and takes a free one, false if there is none
+    static bool NextChunk();
+    static void Write();
+
+    static std::vector<Event>* s_current;
+    static uint32_t s_chunkEvents;
+    static uint64_t s_dropped;
+    static bool s_open;
+    static std::ofstream s_file;
+    static std::vector<std::vector<Event>> s_chunks;
+    static std::deque<std::vector<Event>*> s_free; // guarded by s_mutex
+    static std::deque<std::vector<Event>*> s_full;
+    static bool s_closing;
+    static std::mutex s_mutex;
+    static std::condition_variable s_wakeup;
+    static std::thread s_writer;
+};
+
+} // namespace ns3
+
+#endif // HOT_TRACE_H
@@ -0,0 +1,169 @@
+#include "latency-histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+namespace
+{
+const uint32_t SUB_BUCKETS = 1u << LatencyHistogram::SUB_BUCKET_BITS;
+const uint32_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+// Exact buckets, then HALF_SUB_BUCKETS for each power of two up to MAX_BITS
+const uint32_t N_BUCKETS =
+    SUB_BUCKETS + (LatencyHistogram::MAX_BITS - LatencyHistogram::SUB_BUCKET_BITS) *
+                      HALF_SUB_BUCKETS;
+const uint64_t MAX_VALUE = (uint64_t(1) << LatencyHistogram::MAX_BITS) - 1;
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : m_count(0),
+      m_min(std::numeric_limits<int64_t>::max()),
+      m_max(0),
+      m_sum(0)
+{
+}
+
+uint32_t
+LatencyHistogram::GetIndex(uint64_t value)
+{
+    if (value < SUB_BUCKETS)
+    {
+        return value;
+    }
+    // value >> shift falls into [HALF_SUB_BUCKETS, SUB_BUCKETS)
+    uint32_t shift = 64 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+    return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + (value >> shift) - HALF_SUB_BUCKETS;
+}
+
+uint64_t
+LatencyHistogram::GetHighestValue(uint32_t index)
+{
+    if (index < SUB_BUCKETS)
+    {
+        return index;
+    }
+    uint32_t shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    uint64_t sub = (index - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+void
+LatencyHistogram::Record(Time latency)
+{
+    int64_t value = std::max<int64_t>(latency.GetNanoSeconds(), 0);
+    if (m_counts.empty())
+    {
+        m_counts.assign(N_BUCKETS, 0);
+    }
+    m_counts[GetIndex(std::min<uint64_t>(value, MAX_VALUE))]++;
+    m_count++;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    m_sum += value;
+}
+
+void
+LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+    if (m_counts.empty())
+    {
+        m_counts.assign(N_BUCKETS, 0);
+    }
+    for (uint32_t i = 0; i < N_BUCKETS; ++i)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_sum += other.m_sum;
+}
+
+uint64_t
+LatencyHistogram::GetCount() const
+{
+    return m_count;
+}
+
+Time
+LatencyHistogram::GetMin() const
+{
+    return NanoSeconds(m_count > 0 ? m_min : 0);
+}
+
+Time
+LatencyHistogram::GetMax() const
+{
+    return NanoSeconds(m_max);
+}
+
+Time
+LatencyHistogram::GetMean() const
+{
+    return NanoSeconds(m_count > 0 ? std::llround(m_sum / m_count) : 0);
+}
+
+Time
+LatencyHistogram::GetPercentile(double percentile) const
+{
+    if (m_count == 0)
+    {
+        return NanoSeconds(0);
+    }
+    double rank = std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * m_count);
+    uint64_t target = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < N_BUCKETS; ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= target)
+        {
+            return NanoSeconds(std::min<int64_t>(GetHighestValue(i), m_max));
+        }
+    }
+    return NanoSeconds(m_max);
+}
+
+const std::vector<uint64_t>&
+LatencyHistogram::GetBucketCounts() const
+{
+    return m_counts;
+}
+
+Json::Value
+LatencyHistogram::ToJson() const
+{
+    Json::Value histogram;
+    histogram["count"] = Json::UInt64(m_count);
+    histogram["min"] = GetMin().GetSeconds() * 1000;
+    histogram["mean"] = GetMean().GetSeconds() * 1000;
+    histogram["p50"] = GetPercentile(50).GetSeconds() * 1000;
+    histogram["p90"] = GetPercentile(90).GetSeconds() * 1000;
+    histogram["p99"] = GetPercentile(99).GetSeconds() * 1000;
+    histogram["p999"] = GetPercentile(99.9).GetSeconds() * 1000;
+    histogram["max"] = GetMax().GetSeconds() * 1000;
+    histogram["subBucketBits"] = SUB_BUCKET_BITS;
+
+    Json::Value buckets(Json::arrayValue);
+    for (uint32_t i = 0; i < m_counts.size(); ++i)
+    {
+        if (m_counts[i] > 0)
+        {
+            Json::Value bucket(Json::arrayValue);
+            bucket.append(i);
+            bucket.append(Json::UInt64(m_counts[i]));
+            buckets.append(bucket);
+        }
+    }
+    histogram["buckets"] = buckets;
+    return histogram;
+}
+
+} // namespace ns3
@@ -0,0 +1,60 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "ns3/nstime.h"
+
+#include <json/json.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+// Fixed-memory latency histogram with HDR-style logarithmic buckets. Latencies below
+// 2^SUB_BUCKET_BITS ns are counted exactly; above, every power of two is split into
+// 2^(SUB_BUCKET_BITS - 1) linear sub-buckets, so percentiles are within 1/64 (1.6 %) of
+// the recorded value. Latencies beyond 2^MAX_BITS ns (68 s) are clamped.
+//
+// All histograms share the same bucket layout: they merge by adding their counts, and
+// the exported bucket indices can be merged the same way after the run.
+class LatencyHistogram
+{
+  public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 7;
+    static constexpr uint32_t MAX_BITS = 36;
+
+    LatencyHistogram();
+
+    void Record(Time latency);
+    void Merge(const LatencyHistogram& other);
+
+    uint64_t GetCount() const;
+    Time GetMin() const;
+    Time GetMax() const;
+    Time GetMean() const;
+    // Smallest latency that percentile % of the samples do not exceed, up to the bucket
+    // resolution; zero if nothing was recorded
+    Time GetPercentile(double percentile) const;
+
+    // Count of every bucket, empty if nothing was recorded
+    const std::vector<uint64_t>& GetBucketCounts() const;
+
+    // Summary in milliseconds plus the non-empty buckets as [index, count] pairs
+    Json::Value ToJson() const;
+
+  private:
+    static uint32_t GetIndex(uint64_t value);
+    // Largest value counted in bucket index
+    static uint64_t GetHighestValue(uint32_t index);
+
+    std::vector<uint64_t> m_counts; // allocated on the first sample
+    uint64_t m_count;
+    int64_t m_min; // nanoseconds
+    int64_t m_max;
+    double m_sum;
+};
+
+} // namespace ns3
+
+#endif // LATENCY_HISTOGRAM_H
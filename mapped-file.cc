@@ -0,0 +1,91 @@
+#include "mapped-file.h"
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ns3
+{
+
+MappedFile::MappedFile()
+    : m_data(nullptr),
+      m_size(0),
+      m_mapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (m_mapped)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+}
+
+bool
+MappedFile::Open(const std::string& filename)
+{
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    m_size = st.st_size;
+    if (m_size == 0)
+    {
+        close(fd);
+        return true;
+    }
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        m_size = 0;
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(data);
+    m_mapped = true;
+    return true;
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    m_buffer.resize(file.tellg());
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(m_buffer.data()), m_buffer.size());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return static_cast<bool>(file);
+#endif
+}
+
+const uint8_t*
+MappedFile::GetData() const
+{
+    return m_data;
+}
+
+size_t
+MappedFile::GetSize() const
+{
+    return m_size;
+}
+
+} // namespace ns3
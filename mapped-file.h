@@ -0,0 +1,38 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Read-only memory mapping of a whole file. The contents stay valid for the lifetime
+// of the object, so views into it are shared through std::shared_ptr<MappedFile>.
+class MappedFile
+{
+  public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map filename, returns false if it cannot be opened or mapped
+    bool Open(const std::string& filename);
+
+    const uint8_t* GetData() const;
+    size_t GetSize() const;
+
+  private:
+    const uint8_t* m_data;
+    size_t m_size;
+    bool m_mapped;                 // m_data comes from mmap rather than m_buffer
+    std::vector<uint8_t> m_buffer; // fallback copy on platforms without mmap
+};
+
+} // namespace ns3
+
+#endif // MAPPED_FILE_H
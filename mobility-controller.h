@@ -1,6 +1,8 @@
 #ifndef TRACE_BASED_MOBILITY_MODEL_H
 #define TRACE_BASED_MOBILITY_MODEL_H
 
+#include "mobility-store.h"
+
 #include "ns3/event-id.h"
 #include "ns3/mobility-model.h"
 #include "ns3/nstime.h"
@@ -17,19 +19,35 @@ class TraceBasedMobilityModel : public MobilityModel
     static TypeId GetTypeId(void);
     TraceBasedMobilityModel();
 
+    // Load a trace into a private single-node store. In the legacy PreInterpolate mode the
+    // text trace is parsed in double precision, exactly as before the keyframe store.
     void LoadTrace(std::string filename);
+    // Follow node `index` of a swarm-wide store. In the legacy mode its keyframes are
+    // pre-interpolated from their stored (float, nanosecond) values.
+    void SetTrace(Ptr<const MobilityStore> store, uint32_t index);
+
     virtual Vector DoGetPosition(void) const;
     virtual void DoSetPosition(const Vector& position);
     virtual Vector DoGetVelocity(void) const;
 
   private:
+    // Legacy mode: step through the pre-interpolated trace by events
+    void StartPreInterpolated(void);
     void UpdatePosition(void);
     void Interpolate();
-    std::map<double, Vector> m_trace;
+
+    // Analytic mode: only notify listeners at the original keyframes
+    void NotifyKeyframe(void);
+
+    Ptr<const MobilityStore> m_store;
+    uint32_t m_index;
+    mutable uint32_t m_cursor;
+    std::map<double, Vector> m_trace; // legacy mode keyframes, in seconds
     std::map<double, Vector> m_interpolatedTrace;
     Vector m_position;
     EventId m_event;
     double m_interpolationInterval;
+    bool m_preInterpolate;
 };
 } // namespace ns3
 
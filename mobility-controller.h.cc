@@ -1,10 +1,14 @@
 #include "mobility-controller.h"
 
+#include "binary-trace.h"
+
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
@@ -13,6 +17,18 @@ namespace ns3
 NS_OBJECT_ENSURE_REGISTERED(TraceBasedMobilityModel);
 NS_LOG_COMPONENT_DEFINE("TraceBasedMobilityModel");
 
+namespace
+{
+bool
+IsBinaryTrace(const std::string& filename)
+{
+    char magic[4] = {};
+    std::ifstream file(filename, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return std::memcmp(magic, BINARY_MOBILITY_TRACE_MAGIC, sizeof(magic)) == 0;
+}
+} // namespace
+
 TypeId
 TraceBasedMobilityModel::GetTypeId(void)
 {
@@ -25,19 +41,40 @@ TraceBasedMobilityModel::GetTypeId(void)
                           "Time interval for interpolation in seconds",
                           DoubleValue(0.01), // 10ms默认值
                           MakeDoubleAccessor(&TraceBasedMobilityModel::m_interpolationInterval),
-                          MakeDoubleChecker<double>(0.001, 1.0)); // 1ms到1s的范围
+                          MakeDoubleChecker<double>(0.001, 1.0)) // 1ms到1s的范围
+            .AddAttribute("PreInterpolate",
+                          "Pre-interpolate the trace every InterpolationInterval seconds and "
+                          "update the position by events (legacy behaviour). When false, the "
+                          "position is computed on demand from the keyframes.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TraceBasedMobilityModel::m_preInterpolate),
+                          MakeBooleanChecker());
 
     return tid;
 }
 
 TraceBasedMobilityModel::TraceBasedMobilityModel()
-    : m_interpolationInterval(0.01)
+    : m_index(0),
+      m_cursor(0),
+      m_interpolationInterval(0.01),
+      m_preInterpolate(false)
 {
 }
 
 void
 TraceBasedMobilityModel::LoadTrace(std::string filename)
 {
+    // Binary traces only hold float keyframes, they go through the store in both modes
+    if (!m_preInterpolate || IsBinaryTrace(filename))
+    {
+        Ptr<MobilityStore> store = Create<MobilityStore>();
+        uint32_t index = store->LoadTrace(filename);
+        SetTrace(store, index);
+        return;
+    }
+
+    m_event.Cancel();
+    m_store = nullptr;
     m_trace.clear();
     m_interpolatedTrace.clear();
 
@@ -59,7 +96,6 @@ TraceBasedMobilityModel::LoadTrace(std::string filename)
             NS_LOG_ERROR("Invalid line in trace file" << line);
             continue;
         }
-        NS_LOG_INFO("Loading trace from file: " << filename);
         m_trace[time] = position;
     }
 
@@ -68,7 +104,44 @@ TraceBasedMobilityModel::LoadTrace(std::string filename)
         NS_LOG_ERROR("No valid entries found in trace file" << filename);
         return;
     }
+    StartPreInterpolated();
+}
 
+void
+TraceBasedMobilityModel::SetTrace(Ptr<const MobilityStore> store, uint32_t index)
+{
+    m_event.Cancel();
+    m_trace.clear();
+    m_interpolatedTrace.clear();
+
+    m_store = store;
+    m_index = index;
+    m_cursor = 0;
+
+    MobilityStore::Track track = m_store->GetTrack(m_index);
+    if (track.size == 0)
+    {
+        m_store = nullptr;
+        return;
+    }
+
+    if (m_preInterpolate)
+    {
+        for (uint32_t k = 0; k < track.size; ++k)
+        {
+            m_trace[track.time[k] * 1e-9] = Vector(track.x[k], track.y[k], track.z[k]);
+        }
+        StartPreInterpolated();
+        return;
+    }
+
+    m_position = Vector(track.x[0], track.y[0], track.z[0]);
+    m_event = Simulator::Schedule(Seconds(0.0), &TraceBasedMobilityModel::NotifyKeyframe, this);
+}
+
+void
+TraceBasedMobilityModel::StartPreInterpolated(void)
+{
     Interpolate();
 
     // m_position = m_interpolatedTrace.begin()->second;
@@ -120,7 +193,19 @@ TraceBasedMobilityModel::Interpolate()
 Vector
 TraceBasedMobilityModel::DoGetPosition(void) const
 {
-    return m_position;
+    if (m_preInterpolate || !m_store)
+    {
+        return m_position;
+    }
+
+    // Reuse the batch snapshot when a swarm-wide consumer already evaluated this instant
+    Time now = Simulator::Now();
+    Vector position;
+    if (m_store->GetSnapshotPosition(m_index, now, position))
+    {
+        return position;
+    }
+    return m_store->GetPosition(m_index, now, m_cursor);
 }
 
 void
@@ -132,8 +217,28 @@ TraceBasedMobilityModel::DoSetPosition(const Vector& position)
 Vector
 TraceBasedMobilityModel::DoGetVelocity(void) const
 {
-    // For simplicity, we're not calculating velocity here
-    return Vector(0, 0, 0);
+    if (m_preInterpolate || !m_store)
+    {
+        // For simplicity, we're not calculating velocity in the legacy mode
+        return Vector(0, 0, 0);
+    }
+    return m_store->GetVelocity(m_index, Simulator::Now(), m_cursor);
+}
+
+void
+TraceBasedMobilityModel::NotifyKeyframe(void)
+{
+    NotifyCourseChange();
+
+    Time now = Simulator::Now();
+    uint32_t next = m_store->FindNextKeyframe(m_index, now, m_cursor);
+    MobilityStore::Track track = m_store->GetTrack(m_index);
+    if (next < track.size)
+    {
+        m_event = Simulator::Schedule(NanoSeconds(track.time[next]) - now,
+                                      &TraceBasedMobilityModel::NotifyKeyframe,
+                                      this);
+    }
 }
 
 void
@@ -0,0 +1,393 @@
+#include "mobility-store.h"
+
+#include "trace-loader.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("MobilityStore");
+
+namespace
+{
+// Branch-free interpolation of one coordinate over flat arrays, vectorized by the compiler.
+// It performs the same operations as MobilityStore::GetPosition(), so the batch and the
+// per-node paths return identical positions.
+void
+InterpolateSegments(uint32_t n,
+                    double now,
+                    const double* __restrict segTime,
+                    const double* __restrict segDuration,
+                    const double* __restrict segPos,
+                    const double* __restrict segDelta,
+                    double* __restrict out)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        double alpha = (now - segTime[i]) / segDuration[i];
+        out[i] = segPos[i] + alpha * segDelta[i];
+    }
+}
+} // namespace
+
+MobilityStore::MobilityStore()
+    : m_offsets(1, 0),
+      m_hasSnapshot(false)
+{
+}
+
+uint32_t
+MobilityStore::LoadTrace(const std::string& filename)
+{
+    TraceLoader::MobilityTrace trace;
+    std::string error;
+    TraceLoader::ReadMobilityTrace(filename, trace, error);
+    if (!error.empty())
+    {
+        NS_LOG_ERROR(error);
+    }
+
+    uint32_t node = TraceLoader::AddMobilityTrace(*this, std::move(trace));
+    if (GetTrack(node).size == 0)
+    {
+        NS_LOG_ERROR("No valid entries found in trace file" << filename);
+    }
+    NS_LOG_INFO("Loaded " << GetTrack(node).size << " keyframes from " << filename);
+    return node;
+}
+
+uint32_t
+MobilityStore::AddNode(std::vector<Keyframe> keyframes)
+{
+    // Same semantics as the former per-node std::map: sorted by time, last duplicate wins
+    std::stable_sort(keyframes.begin(),
+                     keyframes.end(),
+                     [](const Keyframe& a, const Keyframe& b) { return a.time < b.time; });
+
+    for (size_t i = 0; i < keyframes.size(); ++i)
+    {
+        if (i + 1 < keyframes.size() && keyframes[i + 1].time == keyframes[i].time)
+        {
+            continue;
+        }
+        m_time.push_back(keyframes[i].time);
+        m_x.push_back(keyframes[i].x);
+        m_y.push_back(keyframes[i].y);
+        m_z.push_back(keyframes[i].z);
+    }
+
+    m_offsets.push_back(m_time.size());
+    m_external.push_back(Track{nullptr, nullptr, nullptr, nullptr, 0});
+    m_hasSnapshot = false;
+    return GetNNodes() - 1;
+}
+
+uint32_t
+MobilityStore::AddNode(const Track& track, std::shared_ptr<const void> keepAlive)
+{
+    NS_ASSERT(track.time != nullptr);
+    m_offsets.push_back(m_time.size());
+    m_external.push_back(track);
+    m_keepAlive.push_back(keepAlive);
+    m_hasSnapshot = false;
+    return GetNNodes() - 1;
+}
+
+uint32_t
+MobilityStore::GetNNodes() const
+{
+    return m_offsets.size() - 1;
+}
+
+MobilityStore::Track
+MobilityStore::GetTrack(uint32_t node) const
+{
+    NS_ASSERT(node < GetNNodes());
+    if (m_external[node].time)
+    {
+        return m_external[node];
+    }
+
+    uint64_t begin = m_offsets[node];
+    Track track;
+    track.time = m_time.data() + begin;
+    track.x = m_x.data() + begin;
+    track.y = m_y.data() + begin;
+    track.z = m_z.data() + begin;
+    track.size = m_offsets[node + 1] - begin;
+    return track;
+}
+
+uint32_t
+MobilityStore::FindNextKeyframe(uint32_t node, Time t, uint32_t& cursor) const
+{
+    Track track = GetTrack(node);
+    int64_t now = t.GetNanoSeconds();
+
+    // Simulation time only moves forward, so the keyframe found last time is
+    // almost always still the right one or its direct successor.
+    auto isNextKeyframe = [&track, now](uint32_t k) {
+        return (k == track.size || track.time[k] > now) && (k == 0 || track.time[k - 1] <= now);
+    };
+
+    if (cursor <= track.size && isNextKeyframe(cursor))
+    {
+        return cursor;
+    }
+    if (cursor < track.size && isNextKeyframe(cursor + 1))
+    {
+        return ++cursor;
+    }
+
+    cursor = std::upper_bound(track.time, track.time + track.size, now) - track.time;
+    return cursor;
+}
+
+Vector
+MobilityStore::GetPosition(uint32_t node, Time t, uint32_t& cursor) const
+{
+    Track track = GetTrack(node);
+    if (track.size == 0)
+    {
+        return Vector(0, 0, 0);
+    }
+
+    uint32_t next = FindNextKeyframe(node, t, cursor);
+    if (next == 0)
+    {
+        return Vector(track.x[0], track.y[0], track.z[0]);
+    }
+    if (next == track.size)
+    {
+        uint32_t last = track.size - 1;
+        return Vector(track.x[last], track.y[last], track.z[last]);
+    }
+
+    uint32_t prev = next - 1;
+    double alpha = static_cast<double>(t.GetNanoSeconds() - track.time[prev]) /
+                   (track.time[next] - track.time[prev]);
+    auto lerp = [alpha](double a, double b) { return a + alpha * (b - a); };
+    return Vector(lerp(track.x[prev], track.x[next]),
+                  lerp(track.y[prev], track.y[next]),
+                  lerp(track.z[prev], track.z[next]));
+}
+
+Vector
+MobilityStore::GetVelocity(uint32_t node, Time t, uint32_t& cursor) const
+{
+    Track track = GetTrack(node);
+    uint32_t next = FindNextKeyframe(node, t, cursor);
+    if (next == 0 || next == track.size)
+    {
+        return Vector(0, 0, 0);
+    }
+
+    uint32_t prev = next - 1;
+    double dt = (track.time[next] - track.time[prev]) * 1e-9;
+    return Vector((static_cast<double>(track.x[next]) - track.x[prev]) / dt,
+                  (static_cast<double>(track.y[next]) - track.y[prev]) / dt,
+                  (static_cast<double>(track.z[next]) - track.z[prev]) / dt);
+}
+
+void
+MobilityStore::UpdateSegment(uint32_t node, Time t) const
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    Track track = GetTrack(node);
+    uint32_t next = FindNextKeyframe(node, t, m_segCursor[node]);
+
+    if (track.size == 0 || next == 0 || next == track.size)
+    {
+        // Hold a keyframe (or the origin): zero displacement over an unbounded segment
+        uint32_t hold = (next == 0) ? 0 : track.size - 1;
+        m_segBegin[node] = (track.size == 0 || next == 0) ? -inf : track.time[hold];
+        m_segEnd[node] = (track.size == 0 || next == track.size) ? inf : track.time[hold];
+        m_segTime[node] = 0;
+        m_segDuration[node] = 1;
+        m_segX[node] = (track.size == 0) ? 0 : track.x[hold];
+        m_segY[node] = (track.size == 0) ? 0 : track.y[hold];
+        m_segZ[node] = (track.size == 0) ? 0 : track.z[hold];
+        m_segDx[node] = 0;
+        m_segDy[node] = 0;
+        m_segDz[node] = 0;
+        return;
+    }
+
+    uint32_t prev = next - 1;
+    m_segBegin[node] = track.time[prev];
+    m_segEnd[node] = track.time[next];
+    m_segTime[node] = track.time[prev];
+    m_segDuration[node] = track.time[next] - track.time[prev];
+    m_segX[node] = track.x[prev];
+    m_segY[node] = track.y[prev];
+    m_segZ[node] = track.z[prev];
+    m_segDx[node] = static_cast<double>(track.x[next]) - track.x[prev];
+    m_segDy[node] = static_cast<double>(track.y[next]) - track.y[prev];
+    m_segDz[node] = static_cast<double>(track.z[next]) - track.z[prev];
+}
+
+void
+MobilityStore::GetPositions(Time t, double* x, double* y, double* z) const
+{
+    uint32_t n = GetNNodes();
+    if (m_segCursor.size() != n)
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        m_segCursor.assign(n, 0);
+        m_segBegin.assign(n, nan);
+        m_segEnd.assign(n, nan);
+        m_segTime.resize(n);
+        m_segDuration.resize(n);
+        m_segX.resize(n);
+        m_segY.resize(n);
+        m_segZ.resize(n);
+        m_segDx.resize(n);
+        m_segDy.resize(n);
+        m_segDz.resize(n);
+    }
+
+    // Nodes only leave their segment at keyframes, so this scalar pass is mostly compares
+    double now = t.GetNanoSeconds();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (!(now >= m_segBegin[i] && now < m_segEnd[i]))
+        {
+            UpdateSegment(i, t);
+        }
+    }
+
+    InterpolateSegments(n,
+                        now,
+                        m_segTime.data(),
+                        m_segDuration.data(),
+                        m_segX.data(),
+                        m_segDx.data(),
+                        x);
+    InterpolateSegments(n,
+                        now,
+                        m_segTime.data(),
+                        m_segDuration.data(),
+                        m_segY.data(),
+                        m_segDy.data(),
+                        y);
+    InterpolateSegments(n,
+                        now,
+                        m_segTime.data(),
+                        m_segDuration.data(),
+                        m_segZ.data(),
+                        m_segDz.data(),
+                        z);
+}
+
+void
+MobilityStore::UpdateSnapshot(Time t) const
+{
+    if (m_hasSnapshot && m_snapshotTime == t)
+    {
+        return;
+    }
+
+    uint32_t n = GetNNodes();
+    m_snapshotX.resize(n);
+    m_snapshotY.resize(n);
+    m_snapshotZ.resize(n);
+    GetPositions(t, m_snapshotX.data(), m_snapshotY.data(), m_snapshotZ.data());
+    m_snapshotTime = t;
+    m_hasSnapshot = true;
+}
+
+const std::vector<double>&
+MobilityStore::GetSnapshotX(Time t) const
+{
+    UpdateSnapshot(t);
+    return m_snapshotX;
+}
+
+const std::vector<double>&
+MobilityStore::GetSnapshotY(Time t) const
+{
+    UpdateSnapshot(t);
+    return m_snapshotY;
+}
+
+const std::vector<double>&
+MobilityStore::GetSnapshotZ(Time t) const
+{
+    UpdateSnapshot(t);
+    return m_snapshotZ;
+}
+
+bool
+MobilityStore::GetSnapshotPosition(uint32_t node, Time t, Vector& position) const
+{
+    if (!m_hasSnapshot || m_snapshotTime != t)
+    {
+        return false;
+    }
+    position = Vector(m_snapshotX[node], m_snapshotY[node], m_snapshotZ[node]);
+    return true;
+}
+
+double
+MobilityStore::GetMaxSpeed() const
+{
+    double maxSpeed = 0;
+    for (uint32_t node = 0; node < GetNNodes(); ++node)
+    {
+        Track track = GetTrack(node);
+        for (uint32_t k = 1; k < track.size; ++k)
+        {
+            double dx = static_cast<double>(track.x[k]) - track.x[k - 1];
+            double dy = static_cast<double>(track.y[k]) - track.y[k - 1];
+            double dz = static_cast<double>(track.z[k]) - track.z[k - 1];
+            double dt = (track.time[k] - track.time[k - 1]) * 1e-9;
+            maxSpeed = std::max(maxSpeed, std::sqrt(dx * dx + dy * dy + dz * dz) / dt);
+        }
+    }
+    return maxSpeed;
+}
+
+uint64_t
+MobilityStore::GetFingerprint() const
+{
+    // FNV-1a over 8-byte words, with the node sizes so that tracks cannot shift
+    const uint64_t prime = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash, prime](const void* data, uint64_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (uint64_t i = 0; i < size; i += 8)
+        {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + i, std::min<uint64_t>(8, size - i));
+            hash = (hash ^ word) * prime;
+        }
+    };
+
+    uint32_t nNodes = GetNNodes();
+    mix(&nNodes, sizeof(nNodes));
+    for (uint32_t node = 0; node < nNodes; ++node)
+    {
+        Track track = GetTrack(node);
+        mix(&track.size, sizeof(track.size));
+        mix(track.time, track.size * sizeof(int64_t));
+        mix(track.x, track.size * sizeof(float));
+        mix(track.y, track.size * sizeof(float));
+        mix(track.z, track.size * sizeof(float));
+    }
+    return hash;
+}
+
+uint64_t
+MobilityStore::GetMemoryUsage() const
+{
+    return m_offsets.capacity() * sizeof(uint64_t) + m_time.capacity() * sizeof(int64_t) +
+           (m_x.capacity() + m_y.capacity() + m_z.capacity()) * sizeof(float) +
+           m_external.capacity() * sizeof(Track);
+}
+
+} // namespace ns3
@@ -0,0 +1,120 @@
+#ifndef MOBILITY_STORE_H
+#define MOBILITY_STORE_H
+
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Keyframes of the whole swarm, kept as one structure-of-arrays store.
+// Node i owns keyframes [m_offsets[i], m_offsets[i + 1]), sorted by time, unless its
+// keyframes are a view into external memory such as a mapped binary trace.
+class MobilityStore : public SimpleRefCount<MobilityStore>
+{
+  public:
+    struct Keyframe
+    {
+        int64_t time; // nanoseconds
+        float x;
+        float y;
+        float z;
+    };
+
+    // Read-only view of the keyframes of one node
+    struct Track
+    {
+        const int64_t* time;
+        const float* x;
+        const float* y;
+        const float* z;
+        uint32_t size;
+    };
+
+    MobilityStore();
+
+    // Parse a "t x y z" trace file and append it as the next node, returns the node index
+    uint32_t LoadTrace(const std::string& filename);
+
+    // Append the next node; keyframes are sorted and duplicated timestamps keep the last one
+    uint32_t AddNode(std::vector<Keyframe> keyframes);
+    // Append the next node as a view into memory kept alive by keepAlive, without copying.
+    // Keyframe times must be strictly increasing.
+    uint32_t AddNode(const Track& track, std::shared_ptr<const void> keepAlive);
+
+    uint32_t GetNNodes() const;
+    Track GetTrack(uint32_t node) const;
+
+    // Index of the first keyframe strictly after t (GetTrack(node).size if none).
+    // cursor caches the previous answer so that forward-moving lookups are O(1).
+    uint32_t FindNextKeyframe(uint32_t node, Time t, uint32_t& cursor) const;
+
+    // Piecewise-linear position and velocity, holding the first/last keyframe outside the trace
+    Vector GetPosition(uint32_t node, Time t, uint32_t& cursor) const;
+    Vector GetVelocity(uint32_t node, Time t, uint32_t& cursor) const;
+
+    // Positions of every node at time t, evaluated in one pass into contiguous x/y/z buffers
+    // of GetNNodes() elements each
+    void GetPositions(Time t, double* x, double* y, double* z) const;
+
+    // Positions of every node at time t; the snapshot is reused until t changes
+    const std::vector<double>& GetSnapshotX(Time t) const;
+    const std::vector<double>& GetSnapshotY(Time t) const;
+    const std::vector<double>& GetSnapshotZ(Time t) const;
+
+    // Position of one node from the current snapshot, if one was taken at time t
+    bool GetSnapshotPosition(uint32_t node, Time t, Vector& position) const;
+
+    // Highest speed between two consecutive keyframes of any node, in m/s
+    double GetMaxSpeed() const;
+
+    // Hash of the keyframe times and positions of every node, identifying the trajectories
+    // that results cached on disk (such as a contact plan) were derived from
+    uint64_t GetFingerprint() const;
+
+    // Bytes used by the keyframe arrays (mapped binary traces are not counted)
+    uint64_t GetMemoryUsage() const;
+
+  private:
+    // Move node's cached segment to the one covering time t
+    void UpdateSegment(uint32_t node, Time t) const;
+    void UpdateSnapshot(Time t) const;
+
+    std::vector<uint64_t> m_offsets;
+    std::vector<int64_t> m_time;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_z;
+    std::vector<Track> m_external; // time == nullptr if the node is stored in the arrays above
+    std::vector<std::shared_ptr<const void>> m_keepAlive;
+
+    // Per-node segment covering the last evaluated time, as flat arrays for the batch kernel.
+    // A node's segment is valid for times in [m_segBegin, m_segEnd) (nanoseconds).
+    mutable std::vector<uint32_t> m_segCursor;
+    mutable std::vector<double> m_segBegin;
+    mutable std::vector<double> m_segEnd;
+    mutable std::vector<double> m_segTime;
+    mutable std::vector<double> m_segDuration;
+    mutable std::vector<double> m_segX;
+    mutable std::vector<double> m_segY;
+    mutable std::vector<double> m_segZ;
+    mutable std::vector<double> m_segDx;
+    mutable std::vector<double> m_segDy;
+    mutable std::vector<double> m_segDz;
+
+    mutable bool m_hasSnapshot;
+    mutable Time m_snapshotTime;
+    mutable std::vector<double> m_snapshotX;
+    mutable std::vector<double> m_snapshotY;
+    mutable std::vector<double> m_snapshotZ;
+};
+
+} // namespace ns3
+
+#endif // MOBILITY_STORE_H
@@ -1,7 +1,12 @@
 #include "options.h"
 
+#include "position-sampler.h"
+
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace ns3
 {
 NS_LOG_COMPONENT_DEFINE("SimulationOptions");
@@ -12,21 +17,107 @@ SimulationOptions::SimulationOptions()
       txPower(23.0),
       rxSensitivity(-82.0),
       rxNoiseFigure(7.0),
-      wifiStandard("80211b")
+      wifiStandard("80211b"),
+      preInterpolateMobility(false),
+      loaderThreads(0),
+      packetWindow(256),
+      gridChannel(false),
+      contactPlan(""),
+      contactRouting(false),
+      staticArp(false),
+      statsWindow(0.1),
+      statsFile(""),
+      flowMonitor(true),
+      resultsFile("simulation-results.flsr"),
+      profileFile("simulation-profile.json"),
+      animation("none"),
+      animationFile("fls-animation.flsa"),
+      animationInterval(0.1),
+      animPacketSampling(100),
+      hotTraceFile(""),
+      positionFile(""),
+      positionInterval(0.1),
+      positionNodes(""),
+      sweep(""),
+      traceDir("scratch/FLS/traces/"),
+      scenarioBundle("")
+{
+}
+
+template <class Visitor>
+void
+SimulationOptions::VisitOptions(Visitor visit)
 {
+    visit("nNodes", "Number of nodes", nNodes);
+    visit("simTime", "Simulation time in seconds", simulationTime);
+    visit("txPower", "Transmission power in dBm", txPower);
+    visit("rxSensitivity", "Receiver sensitivity in dBm", rxSensitivity);
+    visit("noiseFigure", "Receiver noise figure", rxNoiseFigure);
+    visit("wifi", "WiFi standard (80211b/80211ax/80211n/80211ac/80211g)", wifiStandard);
+    visit("preInterpolate",
+          "Use the legacy pre-interpolated mobility updates instead of analytic positions",
+          preInterpolateMobility);
+    visit("loaderThreads",
+          "Number of threads parsing the trace files (0: one per hardware thread)",
+          loaderThreads);
+    visit("packetWindow",
+          "Text packet trace entries parsed ahead per node (0: read whole traces)",
+          packetWindow);
+    visit("gridChannel",
+          "Use a wifi channel that only evaluates the PHYs within reach of the sender",
+          gridChannel);
+    visit("contactPlan",
+          "Contact plan file, reused if it matches the run or computed and saved",
+          contactPlan);
+    visit("contactRouting",
+          "Update multi-hop routes at every topology change of the contact plan",
+          contactRouting);
+    visit("staticArp",
+          "Fill every node's ARP cache with permanent entries so no ARP frames are sent",
+          staticArp);
+    visit("statsWindow", "Length of a statistics window in seconds", statsWindow);
+    visit("statsFile",
+          "File receiving per-node statistics for every window (empty: disabled)",
+          statsFile);
+    visit("flowMonitor",
+          "Collect per-flow statistics with FlowMonitor (false: application counters)",
+          flowMonitor);
+    visit("resultsFile",
+          "Binary file receiving the per-node, per-flow and latency results",
+          resultsFile);
+    visit("profileFile",
+          "File receiving the time and peak memory of every run phase (empty: disabled)",
+          profileFile);
+    visit("animation",
+          "Animation output: none, binary (decimated, sampled) or netanim (full XML)",
+          animation);
+    visit("animFile", "Binary animation output file", animationFile);
+    visit("animInterval", "Seconds between recorded node positions", animationInterval);
+    visit("animPacketSampling",
+          "Record one wifi frame in this many in the binary animation (0: none)",
+          animPacketSampling);
+    visit("hotTraceFile",
+          "Binary dump of every application and IP packet event (needs -DFLS_HOT_TRACE)",
+          hotTraceFile);
+    visit("positionFile", "Binary time series of node positions (empty: disabled)", positionFile);
+    visit("positionInterval", "Seconds between position samples", positionInterval);
+    visit("positionNodes",
+          "Nodes whose positions are sampled, such as 0-9,20 (empty: all)",
+          positionNodes);
+    visit("sweep", "JSON list or grid of option values, all run over traces loaded once", sweep);
+    visit("traceDir", "Directory holding the text or binary trace files", traceDir);
+    visit("scenario",
+          "Scenario bundle built by traces/pack_scenario.py (replaces traceDir)",
+          scenarioBundle);
 }
 
 bool
 SimulationOptions::Parse(int argc, char* argv[])
 {
     CommandLine cmd;
-
-    cmd.AddValue("nNodes", "Number of nodes", nNodes);
-    cmd.AddValue("simTime", "Simulation time in seconds", simulationTime);
-    cmd.AddValue("txPower", "Transmission power in dBm", txPower);
-    cmd.AddValue("rxSensitivity", "Receiver sensitivity in dBm", rxSensitivity);
-    cmd.AddValue("noiseFigure", "Receiver noise figure", rxNoiseFigure);
-    cmd.AddValue("wifi", "WiFi standard (80211b/80211ax/80211n/80211ac/80211g)", wifiStandard);
+    VisitOptions([&cmd](const std::string& name, const std::string& help, auto& value) {
+        cmd.AddValue(name, help, value);
+    });
 
     cmd.Parse(argc, argv);
 
@@ -37,7 +128,78 @@ SimulationOptions::Parse(int argc, char* argv[])
     NS_LOG_INFO("  Rx Sensitivity: " << rxSensitivity << " dBm");
     NS_LOG_INFO("  Noise Figure: " << rxNoiseFigure);
     NS_LOG_INFO("  WiFi Standard: " << wifiStandard);
+    NS_LOG_INFO("  Pre-interpolated Mobility: " << (preInterpolateMobility ? "yes" : "no"));
+    NS_LOG_INFO("  Trace Loader Threads: " << loaderThreads);
+    NS_LOG_INFO("  Packet Trace Window: " << packetWindow);
+    NS_LOG_INFO("  Grid Channel: " << (gridChannel ? "yes" : "no"));
+    if (!contactPlan.empty())
+    {
+        NS_LOG_INFO("  Contact Plan: " << contactPlan);
+    }
+    NS_LOG_INFO("  Contact Routing: " << (contactRouting ? "yes" : "no"));
+    NS_LOG_INFO("  Static ARP: " << (staticArp ? "yes" : "no"));
+    NS_LOG_INFO("  Statistics Window: " << statsWindow << " s");
+    NS_LOG_INFO("  Statistics File: " << (statsFile.empty() ? "none" : statsFile));
+    NS_LOG_INFO("  Flow Monitor: " << (flowMonitor ? "yes" : "no"));
+    NS_LOG_INFO("  Results File: " << resultsFile);
+    NS_LOG_INFO("  Profile File: " << (profileFile.empty() ? "none" : profileFile));
+    NS_LOG_INFO("  Animation: " << animation);
+    if (!hotTraceFile.empty())
+    {
+        NS_LOG_INFO("  Hot Path Trace: " << hotTraceFile);
+    }
+    if (!positionFile.empty())
+    {
+        NS_LOG_INFO("  Position File: " << positionFile << ", every " << positionInterval
+                                        << " s, nodes "
+                                        << (positionNodes.empty() ? "all" : positionNodes));
+    }
+    if (animation == "binary")
+    {
+        NS_LOG_INFO("  Animation File: " << animationFile << ", positions every "
+                                         << animationInterval << " s, one frame in "
+                                         << animPacketSampling);
+    }
+    if (!sweep.empty())
+    {
+        NS_LOG_INFO("  Sweep: " << sweep);
+    }
+    NS_LOG_INFO("  Trace Directory: " << traceDir);
+    if (!scenarioBundle.empty())
+    {
+        NS_LOG_INFO("  Scenario Bundle: " << scenarioBundle);
+    }
 
     return true;
 }
+
+bool
+SimulationOptions::Validate() const
+{
+    const std::vector<std::string> standards =
+        {"80211b", "80211a", "80211g", "80211n", "80211ac", "80211ax"};
+    if (std::find(standards.begin(), standards.end(), wifiStandard) == standards.end())
+    {
+        NS_LOG_ERROR("unknown wifi standard: " << wifiStandard);
+        return false;
+    }
+    std::vector<uint32_t> sampled;
+    if (!positionFile.empty() && !PositionSampler::ParseNodes(positionNodes, nNodes, sampled))
+    {
+        NS_LOG_ERROR("Invalid node subset " << positionNodes);
+        return false;
+    }
+    return true;
+}
+
+bool
+SimulationOptions::IsOption(const std::string& name)
+{
+    bool found = false;
+    SimulationOptions options;
+    options.VisitOptions([&](const std::string& option, const std::string&, auto&) {
+        found = found || option == name;
+    });
+    return found;
+}
 } // namespace ns3
\ No newline at end of file
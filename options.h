@@ -15,6 +15,12 @@ class SimulationOptions
     SimulationOptions();
 
     bool Parse(int argc, char* argv[]);
+    // False, with the reason logged, if a value cannot be simulated; a sweep checks every
+    // point this way before running the first one
+    bool Validate() const;
+
+    // Whether name is one of the options above, rather than an ns-3 attribute or global
+    static bool IsOption(const std::string& name);
 
     uint32_t GetNumberOfNodes() const
     {
@@ -46,13 +52,156 @@ class SimulationOptions
         return wifiStandard;
     }
 
+    bool GetPreInterpolateMobility() const
+    {
+        return preInterpolateMobility;
+    }
+
+    uint32_t GetLoaderThreads() const
+    {
+        return loaderThreads;
+    }
+
+    uint32_t GetPacketWindow() const
+    {
+        return packetWindow;
+    }
+
+    bool GetGridChannel() const
+    {
+        return gridChannel;
+    }
+
+    std::string GetContactPlan() const
+    {
+        return contactPlan;
+    }
+
+    bool GetContactRouting() const
+    {
+        return contactRouting;
+    }
+
+    bool GetStaticArp() const
+    {
+        return staticArp;
+    }
+
+    double GetStatsWindow() const
+    {
+        return statsWindow;
+    }
+
+    std::string GetStatsFile() const
+    {
+        return statsFile;
+    }
+
+    bool GetFlowMonitor() const
+    {
+        return flowMonitor;
+    }
+
+    std::string GetResultsFile() const
+    {
+        return resultsFile;
+    }
+
+    std::string GetProfileFile() const
+    {
+        return profileFile;
+    }
+
+    std::string GetAnimation() const
+    {
+        return animation;
+    }
+
+    std::string GetAnimationFile() const
+    {
+        return animationFile;
+    }
+
+    double GetAnimationInterval() const
+    {
+        return animationInterval;
+    }
+
+    uint32_t GetAnimationPacketSampling() const
+    {
+        return animPacketSampling;
+    }
+
+    std::string GetHotTraceFile() const
+    {
+        return hotTraceFile;
+    }
+
+    std::string GetPositionFile() const
+    {
+        return positionFile;
+    }
+
+    double GetPositionInterval() const
+    {
+        return positionInterval;
+    }
+
+    std::string GetPositionNodes() const
+    {
+        return positionNodes;
+    }
+
+    std::string GetSweep() const
+    {
+        return sweep;
+    }
+
+    std::string GetTraceDir() const
+    {
+        return traceDir;
+    }
+
+    std::string GetScenarioBundle() const
+    {
+        return scenarioBundle;
+    }
+
   private:
-    uint32_t nNodes;          // Number of nodes
-    double simulationTime;    // Simulation duration
-    double txPower;           // Transmission power (dBm)
-    double rxSensitivity;     // Receiver sensitivity (dBm)
-    double rxNoiseFigure;     // Receiver noise figure
-    std::string wifiStandard; // WiFi standard
+    // Calls visit(name, help, member) for every command line option, so that Parse() and
+    // IsOption() share one table
+    template <class Visitor>
+    void VisitOptions(Visitor visit);
+
+    uint32_t nNodes;             // Number of nodes
+    double simulationTime;       // Simulation duration
+    double txPower;              // Transmission power (dBm)
+    double rxSensitivity;        // Receiver sensitivity (dBm)
+    double rxNoiseFigure;        // Receiver noise figure
+    std::string wifiStandard;    // WiFi standard
+    bool preInterpolateMobility; // Use the legacy 10 ms pre-interpolated mobility
+    uint32_t loaderThreads;      // Trace parsing threads (0: one per hardware thread)
+    uint32_t packetWindow;       // Text packet trace entries parsed ahead (0: whole trace)
+    bool gridChannel;            // Only evaluate PHYs near the sender (GridWifiChannel)
+    std::string contactPlan;     // Contact plan file, computed and saved if not valid
+    bool contactRouting;         // Follow the contact plan instead of global routes at 0 s
+    bool staticArp;              // Pre-populate permanent ARP entries for every address
+    double statsWindow;          // Length of a statistics window in seconds
+    std::string statsFile;       // Windowed statistics output, disabled if empty
+    bool flowMonitor;            // Per-flow statistics from FlowMonitor, else app counters
+    std::string resultsFile;     // Binary per-node and per-flow results
+    std::string profileFile;     // Per-phase time and memory profile, disabled if empty
+    std::string animation;       // Animation output: none, binary or netanim
+    std::string animationFile;   // Binary animation output
+    double animationInterval;    // Seconds between recorded node positions
+    uint32_t animPacketSampling; // Record 1 packet in this many (0: none)
+    std::string hotTraceFile;    // Per-packet event dump, needs a FLS_HOT_TRACE build
+    std::string positionFile;    // Sampled node positions, disabled if empty
+    double positionInterval;     // Seconds between position samples
+    std::string positionNodes;   // Sampled nodes such as "0-9,20", all if empty
+    std::string sweep;           // Sweep file, runs every configuration over the same traces
+    std::string traceDir;        // Directory holding the text or binary trace files
+    std::string scenarioBundle;  // Single-file scenario bundle, replaces traceDir if set
 };
 
 } // namespace ns3
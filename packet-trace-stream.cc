@@ -0,0 +1,127 @@
+#include "packet-trace-stream.h"
+
+#include "trace-loader.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("PacketTraceStream");
+
+PacketTraceStream::PacketTraceStream()
+    : m_current(nullptr),
+      m_end(nullptr),
+      m_textPos(nullptr),
+      m_textEnd(nullptr),
+      m_windowSize(0),
+      m_nNodes(0)
+{
+}
+
+PacketTraceStream::PacketTraceStream(PacketTraceList traces)
+    : PacketTraceStream()
+{
+    m_list = traces;
+    if (!m_list.empty())
+    {
+        m_current = &m_list[0];
+        m_end = m_current + m_list.size();
+    }
+}
+
+PacketTraceStream::PacketTraceStream(std::shared_ptr<MappedFile> text,
+                                     uint32_t windowSize,
+                                     uint32_t nNodes,
+                                     const std::string& filename)
+    : PacketTraceStream()
+{
+    m_text = text;
+    m_textPos = reinterpret_cast<const char*>(text->GetData());
+    m_textEnd = m_textPos + text->GetSize();
+    m_filename = filename;
+    m_windowSize = std::max(1u, windowSize);
+    m_nNodes = nNodes;
+    m_window.reserve(m_windowSize);
+    Refill();
+}
+
+PacketTraceStream
+PacketTraceStream::Rewind() const
+{
+    if (m_text)
+    {
+        return PacketTraceStream(m_text, m_windowSize, m_nNodes, m_filename);
+    }
+    return PacketTraceStream(m_list);
+}
+
+bool
+PacketTraceStream::AtEnd() const
+{
+    return m_current == m_end;
+}
+
+const PacketTrace&
+PacketTraceStream::Peek() const
+{
+    NS_ASSERT(!AtEnd());
+    return *m_current;
+}
+
+void
+PacketTraceStream::Next()
+{
+    NS_ASSERT(!AtEnd());
+    if (++m_current == m_end && m_textPos < m_textEnd)
+    {
+        Refill();
+    }
+}
+
+bool
+PacketTraceStream::IsWindowed() const
+{
+    return m_windowSize > 0;
+}
+
+uint64_t
+PacketTraceStream::GetSize() const
+{
+    return m_list.size();
+}
+
+void
+PacketTraceStream::Refill()
+{
+    m_window.clear();
+    while (m_textPos < m_textEnd && m_window.size() < m_windowSize)
+    {
+        const char* eol =
+            static_cast<const char*>(std::memchr(m_textPos, '\n', m_textEnd - m_textPos));
+        eol = eol ? eol : m_textEnd;
+
+        PacketTrace trace;
+        if (TraceLoader::ParsePacketTraceLine(m_textPos, eol, trace) &&
+            (!(trace.flags & PACKET_TRACE_NODE_INDEX) || trace.destination < m_nNodes))
+        {
+            m_window.push_back(trace);
+        }
+        else if (std::find_if(m_textPos, eol, [](char c) {
+                     return c != ' ' && c != '\t' && c != '\r';
+                 }) != eol)
+        {
+            NS_LOG_ERROR("Invalid line in packet trace file " << m_filename << ": "
+                                                              << std::string(m_textPos, eol));
+        }
+        m_textPos = eol + 1;
+    }
+
+    m_current = m_window.data();
+    m_end = m_current + m_window.size();
+}
+
+} // namespace ns3
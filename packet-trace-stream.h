@@ -0,0 +1,71 @@
+#ifndef PACKET_TRACE_STREAM_H
+#define PACKET_TRACE_STREAM_H
+
+#include "mapped-file.h"
+#include "packet-trace.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Sequential reader over the packet trace of one node. Loaded lists and mapped binary
+// traces are walked in place; text traces are parsed on demand into a small look-ahead
+// window that is refilled as entries are consumed, so memory does not grow with the
+// length of the trace.
+class PacketTraceStream
+{
+  public:
+    PacketTraceStream();
+    explicit PacketTraceStream(PacketTraceList traces);
+    // Stream the lines of a mapped text trace, windowSize entries at a time. Lines whose
+    // node index destination is not below nNodes are rejected as invalid.
+    PacketTraceStream(std::shared_ptr<MappedFile> text,
+                      uint32_t windowSize,
+                      uint32_t nNodes,
+                      const std::string& filename);
+
+    // Entries may point into the window, so streams are moved but never copied
+    PacketTraceStream(const PacketTraceStream&) = delete;
+    PacketTraceStream& operator=(const PacketTraceStream&) = delete;
+    PacketTraceStream(PacketTraceStream&&) = default;
+    PacketTraceStream& operator=(PacketTraceStream&&) = default;
+
+    // True once every entry has been consumed
+    bool AtEnd() const;
+    // Current entry; the reference is invalidated by Next()
+    const PacketTrace& Peek() const;
+    void Next();
+
+    // A new stream from the first entry of the same trace, sharing its data; a text
+    // trace is parsed again as the new stream reaches its lines
+    PacketTraceStream Rewind() const;
+
+    // Text traces are windowed; their length is only known once they have been read
+    bool IsWindowed() const;
+    // Total number of entries of a list or binary trace
+    uint64_t GetSize() const;
+
+  private:
+    void Refill();
+
+    PacketTraceList m_list;
+    const PacketTrace* m_current;
+    const PacketTrace* m_end;
+
+    // Text source, only for windowed streams; kept once fully read so Rewind() can start over
+    std::shared_ptr<MappedFile> m_text;
+    const char* m_textPos;
+    const char* m_textEnd;
+    std::string m_filename;
+    uint32_t m_windowSize;
+    uint32_t m_nNodes;
+    std::vector<PacketTrace> m_window;
+};
+
+} // namespace ns3
+
+#endif // PACKET_TRACE_STREAM_H
@@ -1,15 +1,74 @@
 #ifndef PACKET_TRACE_H
 #define PACKET_TRACE_H
 
+#include <cstddef>
 #include <cstdint>
-#include <string>
+#include <memory>
+#include <vector>
 
+// One entry of a packet trace. This is also the record layout of binary packet traces,
+// so a mapped binary trace is used in place.
 struct PacketTrace
 {
-    /* data */
-    double timestamp;
-    uint32_t size;
-    std::string destination;
+    int64_t timestamp;    // send time in nanoseconds
+    uint32_t destination; // IPv4 address in host byte order, or a node index (see flags)
+    uint16_t size;        // payload size in bytes
+    uint16_t flags;       // PacketTraceFlags
+};
+
+static_assert(sizeof(PacketTrace) == 16, "PacketTrace must match the binary record layout");
+
+enum PacketTraceFlags : uint16_t
+{
+    PACKET_TRACE_BROADCAST = 0x1,  // destination is 255.255.255.255
+    PACKET_TRACE_NODE_INDEX = 0x2, // destination is a node index rather than an address
+};
+
+// The packet trace of one node: either owned entries parsed from text, or a view into
+// memory kept alive by another object (a mapped binary trace)
+class PacketTraceList
+{
+  public:
+    PacketTraceList()
+        : m_data(nullptr),
+          m_size(0)
+    {
+    }
+
+    explicit PacketTraceList(std::vector<PacketTrace> traces)
+    {
+        auto owned = std::make_shared<std::vector<PacketTrace>>(std::move(traces));
+        m_data = owned->data();
+        m_size = owned->size();
+        m_keepAlive = owned;
+    }
+
+    PacketTraceList(std::shared_ptr<const void> keepAlive, const PacketTrace* data, size_t size)
+        : m_keepAlive(keepAlive),
+          m_data(data),
+          m_size(size)
+    {
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    const PacketTrace& operator[](size_t i) const
+    {
+        return m_data[i];
+    }
+
+  private:
+    std::shared_ptr<const void> m_keepAlive;
+    const PacketTrace* m_data;
+    size_t m_size;
 };
 
 #endif
@@ -0,0 +1,127 @@
+#include "phase-profiler.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <sys/resource.h>
+
+#include <fstream>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("PhaseProfiler");
+
+PhaseProfiler::PhaseProfiler()
+    : m_start(std::chrono::steady_clock::now()),
+      m_phaseStart(m_start),
+      m_phaseCpuStart(GetCpuSeconds())
+{
+}
+
+double
+PhaseProfiler::GetCpuSeconds()
+{
+    // User and system time of every thread, the trace loader and routing use pools
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+uint64_t
+PhaseProfiler::GetPeakRss()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // kilobytes on Linux
+}
+
+void
+PhaseProfiler::EndPhase(const std::string& name)
+{
+    auto now = std::chrono::steady_clock::now();
+    double cpu = GetCpuSeconds();
+    m_phases.push_back(Phase{name,
+                             std::chrono::duration<double>(now - m_phaseStart).count(),
+                             cpu - m_phaseCpuStart,
+                             GetPeakRss(),
+                             0,
+                             0.0});
+    NS_LOG_INFO("Phase " << name << ": " << m_phases.back().wallSeconds << " s, peak RSS "
+                         << m_phases.back().peakRss / (1 << 20) << " MiB");
+    m_phaseStart = now;
+    m_phaseCpuStart = cpu;
+}
+
+void
+PhaseProfiler::EndSimulationPhase(const std::string& name)
+{
+    EndPhase(name);
+    // Only read here: reading it before the options are parsed would create the simulator
+    // and ignore SimulatorImplementationType, and after Destroy() it would create a new one
+    m_phases.back().events = Simulator::GetEventCount();
+    m_phases.back().simulatedSeconds = Simulator::Now().GetSeconds();
+}
+
+void
+PhaseProfiler::Print(std::ostream& os) const
+{
+    os << "\n=== Run Profile ===\n";
+    for (const Phase& phase : m_phases)
+    {
+        os << "  " << phase.name << ": " << phase.wallSeconds << " s wall, " << phase.cpuSeconds
+           << " s CPU, peak RSS " << phase.peakRss / (1 << 20) << " MiB";
+        if (phase.events > 0 && phase.wallSeconds > 0)
+        {
+            os << ", " << phase.events / phase.wallSeconds << " events/s, "
+               << phase.simulatedSeconds / phase.wallSeconds << " simulated s/s";
+        }
+        os << "\n";
+    }
+    os << "  total: "
+       << std::chrono::duration<double>(m_phaseStart - m_start).count() << " s wall\n";
+}
+
+Json::Value
+PhaseProfiler::ToJson() const
+{
+    Json::Value profile;
+    Json::Value phases(Json::arrayValue);
+    for (const Phase& phase : m_phases)
+    {
+        Json::Value entry;
+        entry["name"] = phase.name;
+        entry["wallSeconds"] = phase.wallSeconds;
+        entry["cpuSeconds"] = phase.cpuSeconds;
+        entry["peakRssBytes"] = Json::UInt64(phase.peakRss);
+        entry["events"] = Json::UInt64(phase.events);
+        if (phase.simulatedSeconds > 0)
+        {
+            entry["simulatedSeconds"] = phase.simulatedSeconds;
+            entry["eventsPerSecond"] = phase.wallSeconds > 0 ? phase.events / phase.wallSeconds
+                                                             : 0.0;
+            entry["simulatedSecondsPerSecond"] =
+                phase.wallSeconds > 0 ? phase.simulatedSeconds / phase.wallSeconds : 0.0;
+        }
+        phases.append(entry);
+    }
+    profile["phases"] = phases;
+    profile["wallSeconds"] = std::chrono::duration<double>(m_phaseStart - m_start).count();
+    profile["peakRssBytes"] = Json::UInt64(GetPeakRss());
+    return profile;
+}
+
+bool
+PhaseProfiler::Write(const std::string& filename) const
+{
+    std::ofstream file(filename);
+    if (!file)
+    {
+        NS_LOG_ERROR("Unable to write profile " << filename);
+        return false;
+    }
+    file << ToJson();
+    return file.good();
+}
+
+} // namespace ns3
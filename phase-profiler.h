@@ -0,0 +1,60 @@
+#ifndef PHASE_PROFILER_H
+#define PHASE_PROFILER_H
+
+#include "ns3/nstime.h"
+
+#include <json/json.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Wall-clock and CPU time of the successive phases of a run, with the peak resident
+// memory reached at the end of each, so the cost of setup steps and of the simulation
+// itself can be compared across runs and node counts without an external profiler.
+//
+// A phase runs from the end of the previous one (or the construction) to EndPhase(). The
+// phase around Simulator::Run() also reports the events executed and the simulated time,
+// as rates per wall-clock second. The profiler never touches the simulator before that
+// phase, so it can be built before the command line is parsed.
+class PhaseProfiler
+{
+  public:
+    PhaseProfiler();
+
+    void EndPhase(const std::string& name);
+    // Same, for the phase that ran the simulator from Now() == 0
+    void EndSimulationPhase(const std::string& name);
+
+    void Print(std::ostream& os) const;
+    Json::Value ToJson() const;
+    bool Write(const std::string& filename) const;
+
+  private:
+    struct Phase
+    {
+        std::string name;
+        double wallSeconds;
+        double cpuSeconds;
+        uint64_t peakRss; // bytes
+        uint64_t events;
+        double simulatedSeconds;
+    };
+
+    static double GetCpuSeconds();
+    static uint64_t GetPeakRss();
+
+    std::vector<Phase> m_phases;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_phaseStart;
+    double m_phaseCpuStart;
+};
+
+} // namespace ns3
+
+#endif // PHASE_PROFILER_H
@@ -0,0 +1,230 @@
+#include "position-sampler.h"
+
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/simulator.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("PositionSampler");
+
+namespace
+{
+struct PositionHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nSampled;
+    uint32_t reserved;
+    int64_t interval; // nanoseconds
+};
+
+static_assert(sizeof(PositionHeader) == 24, "PositionHeader must be 24 bytes");
+
+const char POSITION_MAGIC[4] = {'F', 'L', 'S', 'P'};
+const uint32_t POSITION_VERSION = 1;
+// Samples gathered before the buffers are swapped
+const uint32_t BUFFER_BYTES = 1 << 20;
+} // namespace
+
+void
+GetNodePositions(const NodeContainer& nodes,
+                 const Ptr<MobilityStore>& store,
+                 const std::vector<uint32_t>* indices,
+                 float* out)
+{
+    Time now = Simulator::Now();
+    uint32_t n = indices ? indices->size() : nodes.GetN();
+    if (store)
+    {
+        // One batch evaluation for the whole swarm instead of a virtual call per node
+        const std::vector<double>& x = store->GetSnapshotX(now);
+        const std::vector<double>& y = store->GetSnapshotY(now);
+        const std::vector<double>& z = store->GetSnapshotZ(now);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            uint32_t node = indices ? (*indices)[i] : i;
+            *out++ = x[node];
+            *out++ = y[node];
+            *out++ = z[node];
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            uint32_t node = indices ? (*indices)[i] : i;
+            Vector position = nodes.Get(node)->GetObject<MobilityModel>()->GetPosition();
+            *out++ = position.x;
+            *out++ = position.y;
+            *out++ = position.z;
+        }
+    }
+}
+
+PositionSampler::PositionSampler(const NodeContainer& nodes,
+                                 Ptr<MobilityStore> store,
+                                 const std::vector<uint32_t>& sampled,
+                                 Time interval)
+    : m_nodes(nodes),
+      m_store(store),
+      m_sampled(sampled),
+      m_interval(interval),
+      m_sampleSize((8 + 12 * sampled.size() + 7) / 8 * 8),
+      m_backFull(false),
+      m_finishing(false)
+{
+    NS_ASSERT(interval.IsStrictlyPositive());
+    m_front.reserve(BUFFER_BYTES + m_sampleSize);
+    m_back.reserve(BUFFER_BYTES + m_sampleSize);
+}
+
+PositionSampler::~PositionSampler()
+{
+    Finish();
+}
+
+bool
+PositionSampler::ParseNodes(const std::string& text, uint32_t nNodes, std::vector<uint32_t>& nodes)
+{
+    nodes.clear();
+    if (text.empty())
+    {
+        for (uint32_t i = 0; i < nNodes; ++i)
+        {
+            nodes.push_back(i);
+        }
+        return true;
+    }
+
+    std::istringstream ranges(text);
+    std::string range;
+    while (std::getline(ranges, range, ','))
+    {
+        uint32_t first;
+        uint32_t last;
+        char dash;
+        std::istringstream iss(range);
+        if (!(iss >> first))
+        {
+            return false;
+        }
+        last = first;
+        if (iss >> dash && (dash != '-' || !(iss >> last)))
+        {
+            return false;
+        }
+        if (first > last || last >= nNodes)
+        {
+            return false;
+        }
+        for (uint32_t i = first; i <= last; ++i)
+        {
+            nodes.push_back(i);
+        }
+    }
+    return !nodes.empty();
+}
+
+bool
+PositionSampler::Open(const std::string& filename)
+{
+    m_file.open(filename, std::ios::binary);
+    if (!m_file)
+    {
+        NS_LOG_ERROR("Unable to write position file " << filename);
+        return false;
+    }
+    PositionHeader header;
+    std::memcpy(header.magic, POSITION_MAGIC, 4);
+    header.version = POSITION_VERSION;
+    header.nSampled = m_sampled.size();
+    header.reserved = 0;
+    header.interval = m_interval.GetNanoSeconds();
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(reinterpret_cast<const char*>(m_sampled.data()),
+                 m_sampled.size() * sizeof(uint32_t));
+    const char padding[8] = {};
+    m_file.write(padding, m_sampled.size() % 2 * sizeof(uint32_t));
+
+    m_writer = std::thread(&PositionSampler::Write, this);
+    NS_LOG_INFO("Sampling " << m_sampled.size() << " node positions every "
+                            << m_interval.GetSeconds() << " s to " << filename);
+    return true;
+}
+
+void
+PositionSampler::Start()
+{
+    Sample();
+}
+
+void
+PositionSampler::Sample()
+{
+    Time now = Simulator::Now();
+    size_t offset = m_front.size();
+    m_front.resize(offset + m_sampleSize, 0);
+    char* sample = m_front.data() + offset;
+    int64_t time = now.GetNanoSeconds();
+    std::memcpy(sample, &time, sizeof(time));
+    GetNodePositions(m_nodes,
+                     m_store,
+                     &m_sampled,
+                     reinterpret_cast<float*>(sample + sizeof(time)));
+
+    if (m_front.size() >= BUFFER_BYTES)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Only blocks while the writer is still busy with the previous buffer
+        m_wakeup.wait(lock, [this] { return !m_backFull; });
+        m_front.swap(m_back);
+        m_backFull = true;
+        m_wakeup.notify_all();
+    }
+    m_event = Simulator::Schedule(m_interval, &PositionSampler::Sample, this);
+}
+
+void
+PositionSampler::Write()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_wakeup.wait(lock, [this] { return m_backFull || m_finishing; });
+        if (!m_backFull)
+        {
+            return;
+        }
+        lock.unlock();
+        m_file.write(m_back.data(), m_back.size());
+        m_back.clear();
+        lock.lock();
+        m_backFull = false;
+        m_wakeup.notify_all();
+    }
+}
+
+void
+PositionSampler::Finish()
+{
+    if (!m_writer.joinable())
+    {
+        return;
+    }
+    Simulator::Cancel(m_event);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finishing = true;
+    }
+    m_wakeup.notify_all();
+    m_writer.join();
+    m_file.write(m_front.data(), m_front.size());
+    m_front.clear();
+    m_file.close();
+}
+
+} // namespace ns3
@@ -0,0 +1,77 @@
+#ifndef POSITION_SAMPLER_H
+#define POSITION_SAMPLER_H
+
+#include "mobility-store.h"
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+// Positions at the current time of the given nodes of the container (every node if indices
+// is null), written as float32 x, y, z triples to out. They come from the store snapshot,
+// shared with the rest of the run, or from the mobility models if store is null.
+void GetNodePositions(const NodeContainer& nodes,
+                      const Ptr<MobilityStore>& store,
+                      const std::vector<uint32_t>* indices,
+                      float* out);
+
+// Positions of a subset of the nodes every interval, appended to a binary time series.
+// Samples are gathered in one buffer while a background thread writes the other, so
+// the simulation only waits if the disk is slower than the sampling.
+//
+// Position files ("FLSP") hold a 24-byte header (magic, version, sampled node count,
+// interval in ns), the sampled node indices as uint32 padded to 8 bytes, then one
+// fixed-size sample per interval: int64 time in ns followed by float32 x, y, z for every
+// sampled node, padded to 8 bytes. server/extract_positions.py reads tracks and slices.
+class PositionSampler : public SimpleRefCount<PositionSampler>
+{
+  public:
+    // Positions come from store snapshots, or from the mobility models if store is null
+    PositionSampler(const NodeContainer& nodes,
+                    Ptr<MobilityStore> store,
+                    const std::vector<uint32_t>& sampled,
+                    Time interval);
+    ~PositionSampler();
+
+    // Node subset such as "0-9,20", empty for all nodes; false if invalid
+    static bool ParseNodes(const std::string& text, uint32_t nNodes, std::vector<uint32_t>& nodes);
+
+    bool Open(const std::string& filename);
+    void Start();
+    // Writes the buffered samples and stops the writer
+    void Finish();
+
+  private:
+    void Sample();
+    void Write();
+
+    NodeContainer m_nodes;
+    Ptr<MobilityStore> m_store;
+    std::vector<uint32_t> m_sampled;
+    Time m_interval;
+    uint32_t m_sampleSize; // bytes
+    std::ofstream m_file;
+    std::vector<char> m_front; // filled by the simulation
+    std::vector<char> m_back;  // written by m_writer, guarded by m_mutex
+    bool m_backFull;
+    bool m_finishing;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::thread m_writer;
+    EventId m_event;
+};
+
+} // namespace ns3
+
+#endif // POSITION_SAMPLER_H
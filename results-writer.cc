@@ -0,0 +1,167 @@
+#include "results-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("ResultsWriter");
+
+namespace
+{
+struct ResultsHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nTables;
+    uint32_t reserved;
+};
+
+struct TableHeader
+{
+    char name[32];
+    uint64_t nRows;
+    uint32_t nColumns;
+    uint32_t reserved;
+};
+
+struct ColumnHeader
+{
+    char name[32];
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+};
+
+static_assert(sizeof(ResultsHeader) == 16, "ResultsHeader must be 16 bytes");
+static_assert(sizeof(TableHeader) == 48, "TableHeader must be 48 bytes");
+static_assert(sizeof(ColumnHeader) == 48, "ColumnHeader must be 48 bytes");
+
+const char RESULTS_MAGIC[4] = {'F', 'L', 'S', 'R'};
+const uint32_t RESULTS_VERSION = 1;
+
+// Names are stored NUL-padded, truncated to 31 characters
+void
+CopyName(char (&dest)[32], const std::string& name)
+{
+    std::memset(dest, 0, sizeof(dest));
+    std::memcpy(dest, name.data(), std::min<size_t>(name.size(), sizeof(dest) - 1));
+}
+} // namespace
+
+void
+ResultsWriter::SetTableSuffix(const std::string& suffix)
+{
+    m_suffix = suffix;
+}
+
+void
+ResultsWriter::BeginTable(const std::string& name, uint64_t nRows)
+{
+    m_tables.push_back(Table{name + m_suffix, nRows, {}});
+}
+
+void
+ResultsWriter::AddColumn(const std::string& name,
+                         ColumnType type,
+                         const void* data,
+                         uint64_t size)
+{
+    NS_ASSERT_MSG(!m_tables.empty(), "AddColumn() before BeginTable()");
+    Column column{name, type, std::vector<uint8_t>(size)};
+    // Empty tables pass null pointers, which memcpy does not accept even for no bytes
+    if (size > 0)
+    {
+        std::memcpy(column.data.data(), data, size);
+    }
+    m_tables.back().columns.push_back(std::move(column));
+}
+
+void
+ResultsWriter::AddColumn(const std::string& name, const std::vector<uint32_t>& values)
+{
+    NS_ASSERT(values.size() == m_tables.back().nRows);
+    AddColumn(name, UINT32, values.data(), values.size() * sizeof(uint32_t));
+}
+
+void
+ResultsWriter::AddColumn(const std::string& name, const std::vector<uint64_t>& values)
+{
+    NS_ASSERT(values.size() == m_tables.back().nRows);
+    AddColumn(name, UINT64, values.data(), values.size() * sizeof(uint64_t));
+}
+
+void
+ResultsWriter::AddColumn(const std::string& name, const std::vector<int64_t>& values)
+{
+    NS_ASSERT(values.size() == m_tables.back().nRows);
+    AddColumn(name, INT64, values.data(), values.size() * sizeof(int64_t));
+}
+
+void
+ResultsWriter::AddColumn(const std::string& name, const std::vector<double>& values)
+{
+    NS_ASSERT(values.size() == m_tables.back().nRows);
+    AddColumn(name, FLOAT64, values.data(), values.size() * sizeof(double));
+}
+
+bool
+ResultsWriter::Write(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        NS_LOG_ERROR("Unable to write results file " << filename);
+        return false;
+    }
+
+    uint64_t offset = sizeof(ResultsHeader);
+    for (const Table& table : m_tables)
+    {
+        offset += sizeof(TableHeader) + table.columns.size() * sizeof(ColumnHeader);
+    }
+
+    ResultsHeader header;
+    std::memcpy(header.magic, RESULTS_MAGIC, 4);
+    header.version = RESULTS_VERSION;
+    header.nTables = m_tables.size();
+    header.reserved = 0;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const Table& table : m_tables)
+    {
+        TableHeader tableHeader;
+        CopyName(tableHeader.name, table.name);
+        tableHeader.nRows = table.nRows;
+        tableHeader.nColumns = table.columns.size();
+        tableHeader.reserved = 0;
+        file.write(reinterpret_cast<const char*>(&tableHeader), sizeof(tableHeader));
+        for (const Column& column : table.columns)
+        {
+            ColumnHeader columnHeader;
+            CopyName(columnHeader.name, column.name);
+            columnHeader.type = column.type;
+            columnHeader.reserved = 0;
+            columnHeader.offset = offset;
+            file.write(reinterpret_cast<const char*>(&columnHeader), sizeof(columnHeader));
+            offset += (column.data.size() + 7) / 8 * 8;
+        }
+    }
+
+    const char padding[8] = {};
+    for (const Table& table : m_tables)
+    {
+        for (const Column& column : table.columns)
+        {
+            file.write(reinterpret_cast<const char*>(column.data.data()), column.data.size());
+            file.write(padding, (8 - column.data.size() % 8) % 8);
+        }
+    }
+    return file.good();
+}
+
+} // namespace ns3
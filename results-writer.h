@@ -0,0 +1,66 @@
+#ifndef RESULTS_WRITER_H
+#define RESULTS_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Simulation results as typed column arrays in one binary file, read back by
+// server/fls_results.py. All fields are little-endian.
+//
+// Results file ("FLSR"): 16-byte header (magic, version, table count), then for every
+// table a 48-byte table header (name, row count, column count) followed by its 48-byte
+// column headers (name, type, absolute offset of the data). The column data follows all
+// headers, each column contiguous and 8-byte aligned, so a reader can map a column
+// straight into an array.
+class ResultsWriter
+{
+  public:
+    enum ColumnType : uint32_t
+    {
+        UINT32 = 0,
+        UINT64 = 1,
+        INT64 = 2,
+        FLOAT64 = 3,
+    };
+
+    // Appended to the names of the following tables, so that every run of a sweep keeps
+    // its own tables in one file
+    void SetTableSuffix(const std::string& suffix);
+
+    // Following columns belong to table name, every column must hold nRows values
+    void BeginTable(const std::string& name, uint64_t nRows);
+    void AddColumn(const std::string& name, const std::vector<uint32_t>& values);
+    void AddColumn(const std::string& name, const std::vector<uint64_t>& values);
+    void AddColumn(const std::string& name, const std::vector<int64_t>& values);
+    void AddColumn(const std::string& name, const std::vector<double>& values);
+
+    bool Write(const std::string& filename) const;
+
+  private:
+    struct Column
+    {
+        std::string name;
+        ColumnType type;
+        std::vector<uint8_t> data;
+    };
+
+    struct Table
+    {
+        std::string name;
+        uint64_t nRows;
+        std::vector<Column> columns;
+    };
+
+    void AddColumn(const std::string& name, ColumnType type, const void* data, uint64_t size);
+
+    std::vector<Table> m_tables;
+    std::string m_suffix;
+};
+
+} // namespace ns3
+
+#endif // RESULTS_WRITER_H
@@ -0,0 +1,65 @@
+"""
+Decode a hot path trace dump of NS-FLS (see hot-trace.h) to text or CSV.
+
+    python3 decode_hot_trace.py <trace.flsh> [--csv] [--node N] [--kind KIND]
+
+Text output is one line per event, CSV output has the columns time_ns, node, kind, uid
+and size. Records the simulation dropped because the writer fell behind are reported on
+stderr.
+"""
+import argparse
+import csv
+import struct
+import sys
+
+VERSION = 1
+KINDS = ["APP_TX", "APP_RX", "IP_TX", "IP_RX"]
+
+
+def read_events(path):
+    """Yields (time_ns, uid, node, kind, size) records, then returns the dropped count"""
+    with open(path, "rb") as f:
+        magic, version, event_size, _, dropped = struct.unpack("<4sIIIQ", f.read(24))
+        if magic != b"FLSH" or version != VERSION or event_size != 24:
+            raise ValueError(f"{path} is not a version {VERSION} NS-FLS hot path trace")
+        while True:
+            data = f.read(event_size * 4096)
+            if not data:
+                break
+            yield from struct.iter_unpack("<qQIHH", data[: len(data) - len(data) % 24])
+    return dropped
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode an NS-FLS hot path trace")
+    parser.add_argument("trace")
+    parser.add_argument("--csv", action="store_true", help="write CSV instead of text")
+    parser.add_argument("--node", type=int, help="only events of this node")
+    parser.add_argument("--kind", choices=KINDS, help="only events of this kind")
+    args = parser.parse_args()
+
+    writer = csv.writer(sys.stdout) if args.csv else None
+    if writer:
+        writer.writerow(["time_ns", "node", "kind", "uid", "size"])
+
+    events = read_events(args.trace)
+    while True:
+        try:
+            time, uid, node, kind, size = next(events)
+        except StopIteration as end:
+            dropped = end.value
+            break
+        name = KINDS[kind] if kind < len(KINDS) else str(kind)
+        if (args.node is not None and node != args.node) or (args.kind and name != args.kind):
+            continue
+        if writer:
+            writer.writerow([time, node, name, uid, size])
+        else:
+            print(f"{time * 1e-9:.9f} s  node {node:<5} {name:<7} uid {uid:<10} {size} bytes")
+
+    if dropped:
+        print(f"{dropped} events were dropped during the run", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
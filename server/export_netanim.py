@@ -0,0 +1,104 @@
+"""
+Convert an NS-FLS animation file (see animation-recorder.h) to NetAnim XML.
+
+    python3 export_netanim.py <animation.flsa> <animation.xml>
+
+Every position frame becomes a NetAnim position update for the nodes that moved, and
+every sampled reception a wireless packet from its transmitter, so the XML only grows
+with the recorded interval and packet sampling of the run.
+"""
+import struct
+import sys
+
+VERSION = 1
+POSITIONS = 0
+PACKETS = 1
+TX = 0
+RX = 1
+
+
+def read_animation(path):
+    """(node count, [(time_ns, [x, y, z, ...])], [(time_ns, uid, node, size, type)])"""
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, n_nodes, _, _ = struct.unpack_from("<4sIIIq", data, 0)
+    if magic != b"FLSA" or version != VERSION:
+        raise ValueError(f"{path} is not a version {VERSION} NS-FLS animation file")
+
+    frames, events = [], []
+    offset = 24
+    while offset + 16 <= len(data):
+        kind, count, time = struct.unpack_from("<IIq", data, offset)
+        offset += 16
+        if kind == POSITIONS:
+            size = 12 * count
+            frames.append((time, struct.unpack_from(f"<{3 * count}f", data, offset)))
+        elif kind == PACKETS:
+            size = 24 * count
+            events.extend(struct.iter_unpack("<qQIHH", data[offset : offset + size]))
+        else:
+            raise ValueError(f"unknown chunk type {kind} at offset {offset - 16}")
+        offset += size + (-size % 8)
+    return n_nodes, frames, events
+
+
+def seconds(time_ns):
+    return f"{time_ns * 1e-9:.9f}"
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+    n_nodes, frames, events = read_animation(sys.argv[1])
+
+    # (time, order, line): nodes first, then updates in time order
+    lines = []
+    last = [None] * n_nodes
+    for time, positions in frames:
+        for node in range(n_nodes):
+            position = positions[3 * node : 3 * node + 3]
+            if position == last[node]:
+                continue
+            x, y, z = position
+            if last[node] is None:
+                lines.append(
+                    (time, 0, f'<node id="{node}" sysId="0" locX="{x}" locY="{y}" locZ="{z}" />')
+                )
+                lines.append((time, 1, f'<nu p="c" t="{seconds(time)}" id="{node}" '
+                                       f'r="255" g="0" b="0" />'))
+                lines.append((time, 1, f'<nu p="s" t="{seconds(time)}" id="{node}" '
+                                       f'w="5" h="5" />'))
+            else:
+                lines.append((time, 1, f'<nu p="p" t="{seconds(time)}" id="{node}" '
+                                       f'x="{x}" y="{y}" z="{z}" />'))
+            last[node] = position
+
+    # A sampled frame keeps its transmission, pair every reception with it
+    transmissions = {}
+    n_packets = 0
+    for time, uid, node, _, kind in sorted(events):
+        if kind == TX:
+            transmissions[uid] = (time, node)
+        elif uid in transmissions:
+            tx_time, tx_node = transmissions[uid]
+            lines.append((tx_time, 2, f'<wpr uId="{uid}" fId="{tx_node}" '
+                                      f'fbTx="{seconds(tx_time)}" lbTx="{seconds(tx_time)}" '
+                                      f'tId="{node}" fbRx="{seconds(time)}" '
+                                      f'lbRx="{seconds(time)}" />'))
+            n_packets += 1
+
+    lines.sort(key=lambda line: (line[1] != 0, line[0], line[1]))
+    with open(sys.argv[2], "w") as f:
+        f.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+        f.write('<anim ver="netanim-3.108" filetype="animation" >\n')
+        for _, _, line in lines:
+            f.write(line + "\n")
+        f.write("</anim>\n")
+
+    print(f"Exported {n_nodes} nodes, {len(frames)} frames and {n_packets} packets "
+          f"to {sys.argv[2]}")
+
+
+if __name__ == "__main__":
+    main()
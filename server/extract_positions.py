@@ -0,0 +1,87 @@
+"""
+Extract node tracks or swarm snapshots from an NS-FLS position file (see
+position-sampler.h) as CSV.
+
+    python3 extract_positions.py <positions.flsp> --node N [--from T] [--to T]
+    python3 extract_positions.py <positions.flsp> --time T
+
+--node writes the track of node N (time, x, y, z), optionally limited to [from, to]
+seconds. --time writes the position of every sampled node (node, x, y, z) at the last
+sample at or before T seconds. Samples have a fixed size, so only the requested ones
+are read.
+"""
+import argparse
+import csv
+import struct
+import sys
+
+VERSION = 1
+
+
+class PositionFile:
+    def __init__(self, path):
+        self.file = open(path, "rb")
+        header = struct.unpack("<4sIIIq", self.file.read(24))
+        magic, version, n_sampled, _, self.interval = header
+        if magic != b"FLSP" or version != VERSION:
+            raise ValueError(f"{path} is not a version {VERSION} NS-FLS position file")
+        self.nodes = list(struct.unpack(f"<{n_sampled}I", self.file.read(4 * n_sampled)))
+        self.data_offset = 24 + (4 * n_sampled + 7) // 8 * 8
+        self.sample_size = (8 + 12 * n_sampled + 7) // 8 * 8
+        self.file.seek(0, 2)
+        self.n_samples = (self.file.tell() - self.data_offset) // self.sample_size
+        self.start = self.read_time(0) if self.n_samples else 0
+
+    def read_time(self, index):
+        self.file.seek(self.data_offset + index * self.sample_size)
+        return struct.unpack("<q", self.file.read(8))[0]
+
+    def read_sample(self, index):
+        """(time_ns, [x, y, z, ...]) of sample index"""
+        self.file.seek(self.data_offset + index * self.sample_size)
+        data = self.file.read(self.sample_size)
+        values = struct.unpack_from(f"<{3 * len(self.nodes)}f", data, 8)
+        return struct.unpack_from("<q", data)[0], values
+
+    def index_at(self, seconds):
+        """Last sample at or before seconds, samples are taken every interval from start"""
+        index = (round(seconds * 1e9) - self.start) // self.interval
+        return max(0, min(self.n_samples - 1, index))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Extract NS-FLS node positions as CSV")
+    parser.add_argument("positions")
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument("--node", type=int, help="track of this node")
+    group.add_argument("--time", type=float, help="all sampled nodes at this time (s)")
+    parser.add_argument("--from", dest="begin", type=float, default=0.0)
+    parser.add_argument("--to", dest="end", type=float)
+    args = parser.parse_args()
+
+    positions = PositionFile(args.positions)
+    if positions.n_samples == 0:
+        sys.exit(f"No samples in {args.positions}")
+    writer = csv.writer(sys.stdout)
+
+    if args.time is not None:
+        time, values = positions.read_sample(positions.index_at(args.time))
+        writer.writerow(["node", "x", "y", "z"])
+        for i, node in enumerate(positions.nodes):
+            writer.writerow([node] + list(values[3 * i : 3 * i + 3]))
+        print(f"Snapshot at {time / 1e9} s", file=sys.stderr)
+        return
+
+    if args.node not in positions.nodes:
+        sys.exit(f"Node {args.node} was not sampled")
+    column = positions.nodes.index(args.node)
+    first = positions.index_at(args.begin)
+    last = positions.n_samples - 1 if args.end is None else positions.index_at(args.end)
+    writer.writerow(["time", "x", "y", "z"])
+    for index in range(first, last + 1):
+        time, values = positions.read_sample(index)
+        writer.writerow([time / 1e9] + list(values[3 * column : 3 * column + 3]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,167 @@
+"""
+Read the binary results file written by NS-FLS (see results-writer.h).
+
+    python3 fls_results.py <results.flsr>                       list the tables
+    python3 fls_results.py <results.flsr> <table> [options]     print a table as CSV
+
+Options:
+    --where COLUMN OP VALUE   keep the rows matching, OP is one of == != < <= > >=
+    --columns A,B,...         only output these columns
+    --sum / --mean / --min / --max COLUMN
+                              print the aggregate of a column over the kept rows
+    --output FILE             write the CSV to FILE instead of stdout
+
+Tables of a sweep point N are named "<table>@N"; asking for the bare table name reads
+all points at once, with the point in an added "point" column.
+
+As a library, load() returns {table name: {column name: values}}. The values are numpy
+arrays mapped straight from the file when numpy is installed, tuples otherwise.
+"""
+import argparse
+import csv
+import operator
+import struct
+import sys
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+VERSION = 1
+# Column type -> (struct format, numpy dtype)
+TYPES = {0: ("I", "<u4"), 1: ("Q", "<u8"), 2: ("q", "<i8"), 3: ("d", "<f8")}
+OPERATORS = {
+    "==": operator.eq,
+    "!=": operator.ne,
+    "<": operator.lt,
+    "<=": operator.le,
+    ">": operator.gt,
+    ">=": operator.ge,
+}
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, n_tables, _ = struct.unpack_from("<4sIII", data, 0)
+    if magic != b"FLSR" or version != VERSION:
+        raise ValueError(f"{path} is not a version {VERSION} NS-FLS results file")
+
+    tables = {}
+    offset = 16
+    for _ in range(n_tables):
+        name, n_rows, n_columns, _ = struct.unpack_from("<32sQII", data, offset)
+        offset += 48
+        columns = {}
+        for _ in range(n_columns):
+            column, kind, _, start = struct.unpack_from("<32sIIQ", data, offset)
+            offset += 48
+            fmt, dtype = TYPES[kind]
+            if numpy is not None:
+                values = numpy.frombuffer(data, dtype=dtype, count=n_rows, offset=start)
+            else:
+                values = struct.unpack_from(f"<{n_rows}{fmt}", data, start)
+            columns[column.rstrip(b"\0").decode()] = values
+        tables[name.rstrip(b"\0").decode()] = columns
+    return tables
+
+
+def row_count(table):
+    return len(next(iter(table.values()))) if table else 0
+
+
+def combine(tables, name):
+    """Tables name@0, name@1, ... of a sweep as one table with a leading point column"""
+    points = sorted(
+        int(key.rpartition("@")[2])
+        for key in tables
+        if key.rpartition("@")[0] == name and key.rpartition("@")[2].isdigit()
+    )
+    if not points:
+        return None
+    combined = {"point": []}
+    for point in points:
+        table = tables[f"{name}@{point}"]
+        combined["point"].extend([point] * row_count(table))
+        for column, values in table.items():
+            combined.setdefault(column, []).extend(values)
+    return combined
+
+
+def select(table, where=()):
+    """Rows of table matching every (column, op, value) of where, as a new table"""
+    rows = [
+        i
+        for i in range(row_count(table))
+        if all(OPERATORS[op](table[column][i], value) for column, op, value in where)
+    ]
+    return {name: [values[i] for i in rows] for name, values in table.items()}
+
+
+def aggregate(values, function):
+    if len(values) == 0:
+        return None
+    if function == "sum":
+        return sum(values)
+    if function == "mean":
+        return sum(values) / len(values)
+    return min(values) if function == "min" else max(values)
+
+
+def write_csv(table, out):
+    writer = csv.writer(out)
+    writer.writerow(list(table))
+    writer.writerows(zip(*table.values()))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Read an NS-FLS binary results file")
+    parser.add_argument("results")
+    parser.add_argument("table", nargs="?")
+    parser.add_argument("--where", nargs=3, action="append", default=[],
+                        metavar=("COLUMN", "OP", "VALUE"))
+    parser.add_argument("--columns")
+    parser.add_argument("--output")
+    for function in ("sum", "mean", "min", "max"):
+        parser.add_argument(f"--{function}", action="append", default=[], metavar="COLUMN")
+    args = parser.parse_args()
+
+    tables = load(args.results)
+    if args.table is None:
+        for name, table in tables.items():
+            print(f"{name}: {row_count(table)} rows, columns {', '.join(table)}")
+        return
+    table = tables[args.table] if args.table in tables else combine(tables, args.table)
+    if table is None:
+        sys.exit(f"No table {args.table} in {args.results}, tables: {', '.join(tables)}")
+
+    for column, op, _ in args.where:
+        if column not in table or op not in OPERATORS:
+            sys.exit(f"Invalid condition on {column} with {op}")
+    where = [(column, op, float(value)) for column, op, value in args.where]
+    columns = args.columns.split(",") if args.columns else None
+    for column in columns or []:
+        if column not in table:
+            sys.exit(f"No column {column} in table {args.table}")
+    rows = select(table, where)
+
+    aggregates = [(f, c) for f in ("sum", "mean", "min", "max") for c in getattr(args, f)]
+    if aggregates:
+        for function, column in aggregates:
+            if column not in rows:
+                sys.exit(f"No column {column} in table {args.table}")
+            print(f"{function}({column}) = {aggregate(rows[column], function)}")
+        return
+
+    if columns:
+        rows = {name: rows[name] for name in columns}
+    if args.output:
+        with open(args.output, "w", newline="") as f:
+            write_csv(rows, f)
+    else:
+        write_csv(rows, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
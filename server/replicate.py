@@ -0,0 +1,216 @@
+"""
+Run independent replications of an NS-FLS simulation in parallel and report the means
+of the swarm statistics with confidence intervals.
+
+    python3 replicate.py --runs N [--jobs J] [--sweep FILE] [...] -- [simulation options]
+
+Run from the ns-3 directory. Every replication is a separate fls-simulation process
+with its own RngRun (first-run, first-run + 1, ...), working directory and log under
+output-dir/point-P/run-R, and up to J of them run at once (default one per core). With
+--sweep, every point of the sweep file (same format as the --sweep option of the
+simulation) is replicated N times with its settings appended to the simulation options;
+the points share the same RngRun values, so they are compared on the same random streams.
+
+For every point, the mean, standard deviation and Student-t confidence interval over the
+replications are printed as CSV for the NodeStats totals (statistics), the application
+TrafficStats totals (traffic) and the latency percentiles of simulation-results.json,
+and written with the values of every run to output-dir/replications.json.
+"""
+import argparse
+import concurrent.futures
+import itertools
+import json
+import math
+import os
+import shlex
+import subprocess
+import sys
+
+METRICS = {
+    "statistics": ["txPackets", "rxPackets", "lostPackets", "txBytes", "rxBytes",
+                   "packetLossRate", "meanDelay", "meanJitter"],
+    "traffic": ["sentPackets", "sentBytes", "receivedPackets", "receivedBytes"],
+    "latency": ["mean", "p50", "p90", "p99", "p999", "max"],
+}
+# Input files of the simulation, made absolute since every run has its own directory
+PATH_OPTIONS = ["traceDir", "scenario", "contactPlan"]
+DEFAULT_TRACE_DIR = "scratch/FLS/traces/"
+
+
+def incomplete_beta(a, b, x):
+    """Regularized incomplete beta function I_x(a, b), by its continued fraction"""
+    if x <= 0 or x >= 1:
+        return 0.0 if x <= 0 else 1.0
+    if x > (a + 1) / (a + b + 2):
+        return 1.0 - incomplete_beta(b, a, 1.0 - x)
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b)
+                     + a * math.log(x) + b * math.log(1 - x)) / a
+    tiny = 1e-300
+    c, d = 1.0, 1.0 - (a + b) * x / (a + 1)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    result = d
+    for m in range(1, 300):
+        for numerator in (m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+                          -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))):
+            d = 1.0 + numerator * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + numerator / c
+            c = c if abs(c) > tiny else tiny
+            result *= c * d
+        if abs(c * d - 1.0) < 1e-15:
+            break
+    return front * result
+
+
+def t_quantile(p, df):
+    """Quantile p > 0.5 of Student's t distribution with df degrees of freedom"""
+    def cdf(t):
+        return 1.0 - 0.5 * incomplete_beta(df / 2, 0.5, df / (df + t * t))
+
+    low, high = 0.0, 1e4
+    for _ in range(200):
+        middle = (low + high) / 2
+        if cdf(middle) < p:
+            low = middle
+        else:
+            high = middle
+    return (low + high) / 2
+
+
+def summarize(values, confidence):
+    """(n, mean, stddev, ci low, ci high) of the replication values"""
+    n = len(values)
+    mean = sum(values) / n
+    if n < 2:
+        return n, mean, 0.0, mean, mean
+    stddev = math.sqrt(sum((v - mean) ** 2 for v in values) / (n - 1))
+    half = t_quantile(0.5 + confidence / 2, n - 1) * stddev / math.sqrt(n)
+    return n, mean, stddev, mean - half, mean + half
+
+
+def load_sweep(path):
+    """Settings of every point, the points combined with every combination of the grid"""
+    with open(path) as f:
+        sweep = json.load(f)
+    points = sweep.get("points") or [{}]
+    grid = sweep.get("grid", {})
+    names = sorted(grid)
+    return [dict(point, **dict(zip(names, values)))
+            for point in points
+            for values in itertools.product(*(grid[name] for name in names))]
+
+
+def option_value(value):
+    # Same spelling as the simulation's own sweeps, booleans as true/false
+    return value if isinstance(value, str) else json.dumps(value)
+
+
+def simulation_arguments(arguments):
+    """Forwarded options with the input paths made absolute"""
+    forwarded = []
+    given = set()
+    for argument in arguments:
+        name, _, value = argument.lstrip("-").partition("=")
+        if name in ("RngRun", "sweep"):
+            sys.exit(f"--{name} is set by the runner, use --first-run or --sweep instead")
+        if name in PATH_OPTIONS and value:
+            argument = f"--{name}={os.path.abspath(value)}"
+        given.add(name)
+        forwarded.append(argument)
+    if "traceDir" not in given and "scenario" not in given:
+        forwarded.append(f"--traceDir={os.path.abspath(DEFAULT_TRACE_DIR)}")
+    return forwarded
+
+
+def run(ns3, directory, arguments):
+    """Runs one replication in directory, returns its summary or None if it failed"""
+    os.makedirs(directory, exist_ok=True)
+    command = [ns3, "run", "--no-build", f"--cwd={os.path.abspath(directory)}",
+               shlex.join(["fls-simulation"] + arguments)]
+    with open(os.path.join(directory, "run.log"), "w") as log:
+        status = subprocess.run(command, stdout=log, stderr=subprocess.STDOUT).returncode
+    summary = os.path.join(directory, "simulation-results.json")
+    if status != 0 or not os.path.exists(summary):
+        return None
+    with open(summary) as f:
+        return json.load(f)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Run NS-FLS replications in parallel and report confidence intervals",
+        epilog="Remaining options are passed to every run of fls-simulation.")
+    parser.add_argument("--runs", type=int, required=True, help="replications per point")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(),
+                        help="simultaneous runs (default one per core)")
+    parser.add_argument("--first-run", type=int, default=1, help="RngRun of the first run")
+    parser.add_argument("--sweep", help="sweep file, every point is replicated")
+    parser.add_argument("--confidence", type=float, default=0.95)
+    parser.add_argument("--output-dir", default="replications")
+    parser.add_argument("--ns3", default="./ns3", help="ns3 script of the build")
+    args, remaining = parser.parse_known_args()
+    if remaining and remaining[0] == "--":
+        remaining = remaining[1:]
+
+    base = simulation_arguments(remaining)
+    points = load_sweep(args.sweep) if args.sweep else [{}]
+    jobs = []
+    for point, settings in enumerate(points):
+        for replication in range(args.runs):
+            rng_run = args.first_run + replication
+            arguments = base + [f"--{name}={option_value(value)}"
+                                for name, value in settings.items()]
+            arguments.append(f"--RngRun={rng_run}")
+            directory = os.path.join(args.output_dir, f"point-{point}", f"run-{rng_run}")
+            jobs.append((point, rng_run, directory, arguments))
+
+    # The first run computes the contact plan, or checks that it matches the traces, alone;
+    # the others then reuse it
+    contact_plan = any(a.startswith("--contactPlan=") for a in base)
+    summaries = {}
+    if contact_plan:
+        point, rng_run, directory, arguments = jobs.pop(0)
+        summaries[(point, rng_run)] = run(args.ns3, directory, arguments)
+
+    total = len(jobs) + len(summaries)
+    print(f"Running {total} simulations, {args.jobs} at a time", file=sys.stderr)
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = {pool.submit(run, args.ns3, directory, arguments): (point, rng_run)
+                   for point, rng_run, directory, arguments in jobs}
+        for future in concurrent.futures.as_completed(futures):
+            summaries[futures[future]] = future.result()
+            print(f"{len(summaries)} of {total} done", file=sys.stderr, end="\r")
+    print(file=sys.stderr)
+
+    report = {"confidence": args.confidence, "arguments": base, "points": []}
+    print("point,metric,n,mean,stddev,ciLow,ciHigh")
+    for point, settings in enumerate(points):
+        runs = sorted((rng_run, summary) for (p, rng_run), summary in summaries.items()
+                      if p == point)
+        failed = [rng_run for rng_run, summary in runs if summary is None]
+        if failed:
+            print(f"Point {point}: runs {failed} failed, see their run.log", file=sys.stderr)
+        succeeded = [(rng_run, summary) for rng_run, summary in runs if summary is not None]
+
+        metrics = {}
+        for section, names in METRICS.items():
+            for name in names:
+                values = [summary[section][name] for _, summary in succeeded
+                          if name in summary.get(section, {})]
+                if not values:
+                    continue
+                n, mean, stddev, low, high = summarize(values, args.confidence)
+                metric = f"{section}.{name}"
+                metrics[metric] = {"n": n, "mean": mean, "stddev": stddev,
+                                   "ciLow": low, "ciHigh": high, "values": values}
+                print(f"{point},{metric},{n},{mean:.6g},{stddev:.6g},{low:.6g},{high:.6g}")
+        report["points"].append({"point": point, "settings": settings,
+                                 "runs": [rng_run for rng_run, _ in succeeded],
+                                 "failedRuns": failed, "metrics": metrics})
+
+    with open(os.path.join(args.output_dir, "replications.json"), "w") as f:
+        json.dump(report, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -4,6 +4,8 @@ import subprocess
 import json
 import os
 
+import fls_results
+
 app = Flask(__name__)
 CORS(app)  # 允许跨域请求，这样前端可以访问不同端口的后端
 
@@ -55,6 +57,14 @@ def run_simulation():
         try:
             with open('/path/to/your/ns-3/simulation-results.json', 'r') as f:
                 results = json.load(f)
+            # 每个节点和每条流的统计在二进制结果文件中
+            tables = fls_results.load(
+                os.path.join('/path/to/your/ns-3', results['resultsFile']))
+            results['tables'] = {
+                name: {column: [v.item() if hasattr(v, 'item') else v for v in values]
+                       for column, values in table.items()}
+                for name, table in tables.items()
+            }
         except FileNotFoundError:
             # 如果结果文件不存在，尝试从输出中解析结果
             results = {
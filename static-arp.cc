@@ -0,0 +1,90 @@
+#include "static-arp.h"
+
+#include "ns3/arp-cache.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/log.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("StaticArp");
+
+StaticArp::StaticArp(const NetDeviceContainer& devices, const Ipv4InterfaceContainer& interfaces)
+    : m_nNodes(devices.GetN()),
+      m_nAvoidedFrames(0)
+{
+    NS_ASSERT(interfaces.GetN() == m_nNodes);
+    NeighborCacheHelper neighborCache;
+    neighborCache.PopulateNeighborCache(interfaces);
+
+    for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+        m_index[GetKey(Mac48Address::ConvertFrom(devices.Get(i)->GetAddress()))] = i;
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+        if (device)
+        {
+            device->GetPhy()->TraceConnectWithoutContext(
+                "PhyTxBegin",
+                MakeCallback(&StaticArp::PhyTxBegin, this));
+        }
+    }
+
+    std::pair<Ptr<Ipv4>, uint32_t> interface = interfaces.Get(0);
+    Ptr<Ipv4L3Protocol> ipv4 = DynamicCast<Ipv4L3Protocol>(interface.first);
+    m_aliveTimeout = ipv4->GetInterface(interface.second)->GetArpCache()->GetAliveTimeout();
+    NS_LOG_INFO("Populated the ARP caches of " << m_nNodes << " interfaces");
+}
+
+uint64_t
+StaticArp::GetKey(const Mac48Address& address)
+{
+    uint8_t buffer[6];
+    address.CopyTo(buffer);
+    uint64_t key = 0;
+    for (uint8_t byte : buffer)
+    {
+        key = (key << 8) | byte;
+    }
+    return key;
+}
+
+void
+StaticArp::PhyTxBegin(Ptr<const Packet> packet, double txPowerW)
+{
+    WifiMacHeader header;
+    packet->PeekHeader(header);
+    if (!header.IsData() || header.GetAddr1().IsGroup())
+    {
+        return;
+    }
+    auto sender = m_index.find(GetKey(header.GetAddr2()));
+    auto receiver = m_index.find(GetKey(header.GetAddr1()));
+    if (sender == m_index.end() || receiver == m_index.end())
+    {
+        return;
+    }
+
+    // A dynamic entry stays alive for AliveTimeout after resolution, whatever the traffic
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    auto resolved =
+        m_resolved.try_emplace(uint64_t(sender->second) * m_nNodes + receiver->second, now);
+    if (resolved.second || now - resolved.first->second >= m_aliveTimeout.GetNanoSeconds())
+    {
+        resolved.first->second = now;
+        // ARP request broadcast and unicast reply
+        m_nAvoidedFrames += 2;
+    }
+}
+
+uint64_t
+StaticArp::GetNAvoidedFrames() const
+{
+    return m_nAvoidedFrames;
+}
+
+} // namespace ns3
@@ -16,15 +16,30 @@ StatisticsManager::~StatisticsManager()
 }
 
 void
-StatisticsManager::Setup(Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier)
+StatisticsManager::Setup(Ptr<FlowMonitor> monitor,
+                         Ptr<Ipv4FlowClassifier> classifier,
+                         Ptr<const AddressIndex> addresses)
 {
     m_flowMonitor = monitor;
     m_classifier = classifier;
+    m_addresses = addresses;
+}
+
+void
+StatisticsManager::Setup(Ptr<const AppStatistics> statistics)
+{
+    m_appStatistics = statistics;
 }
 
 void
 StatisticsManager::CollectStatistics()
 {
+    if (m_appStatistics)
+    {
+        AggregateAppStats();
+        CalculateNodeStats();
+        return;
+    }
     if (!m_flowMonitor || !m_classifier)
     {
         std::cout << "FlowMonitor or classifier not initialized!" << std::endl;
@@ -50,30 +65,55 @@ StatisticsManager::AggregateFlowStats()
         Ipv4FlowClassifier::FiveTuple t = m_classifier->FindFlow(flow.first);
 
         // 获取源节点和目标节点的ID
-        uint32_t sourceNode = (t.sourceAddress.Get() & 0xFF) - 1;
-        uint32_t destNode = (t.destinationAddress.Get() & 0xFF) - 1;
+        uint32_t sourceNode = m_addresses->GetNode(t.sourceAddress);
+        uint32_t destNode = m_addresses->GetNode(t.destinationAddress);
+        if (sourceNode == AddressIndex::NONE)
+        {
+            continue;
+        }
 
         // 更新源节点统计
         m_nodeStats[sourceNode].txBytes += flow.second.txBytes;
         m_nodeStats[sourceNode].txPackets += flow.second.txPackets;
         m_nodeStats[sourceNode].lostPackets += flow.second.lostPackets;
 
-        // 更新目标节点统计
+        // 更新目标节点统计, broadcast flows have no single destination node
+        if (destNode == AddressIndex::NONE)
+        {
+            continue;
+        }
         m_nodeStats[destNode].rxBytes += flow.second.rxBytes;
         m_nodeStats[destNode].rxPackets += flow.second.rxPackets;
 
         // 更新延迟统计
-        if (flow.second.rxPackets > 0)
+        // Sums over all incoming flows, the means are taken in CalculateNodeStats()
+        m_nodeStats[destNode].totalDelay += flow.second.delaySum.GetSeconds();
+        if (flow.second.rxPackets > 1)
         {
-            double delay = flow.second.delaySum.GetSeconds() / flow.second.rxPackets;
-            m_nodeStats[destNode].totalDelay += delay;
-            m_nodeStats[destNode].meanDelay = delay;
-            m_nodeStats[destNode].meanJitter =
-                flow.second.jitterSum.GetSeconds() / (flow.second.rxPackets - 1);
+            m_nodeStats[destNode].totalJitter += flow.second.jitterSum.GetSeconds();
+            m_nodeStats[destNode].jitterSamples += flow.second.rxPackets - 1;
         }
     }
 }
 
+void
+StatisticsManager::AggregateAppStats()
+{
+    m_nodeStats.clear();
+    for (uint32_t node = 0; node < m_appStatistics->GetNNodes(); ++node)
+    {
+        NodeStats& stats = m_nodeStats[node];
+        stats.txBytes = m_appStatistics->GetTxBytes(node);
+        stats.rxBytes = m_appStatistics->GetRxBytes(node);
+        stats.txPackets = m_appStatistics->GetTxPackets(node);
+        stats.rxPackets = m_appStatistics->GetRxPackets(node);
+        stats.lostPackets = m_appStatistics->GetLostPackets(node);
+        stats.totalDelay = m_appStatistics->GetDelaySum(node);
+        stats.totalJitter = m_appStatistics->GetJitterSum(node);
+        stats.jitterSamples = m_appStatistics->GetJitterSamples(node);
+    }
+}
+
 void
 StatisticsManager::CalculateNodeStats()
 {
@@ -86,6 +126,15 @@ StatisticsManager::CalculateNodeStats()
         // 计算吞吐量 (Mbps)
         stats.throughput = (stats.rxBytes * 8.0) / simulationTime / 1000000;
 
+        if (stats.rxPackets > 0)
+        {
+            stats.meanDelay = stats.totalDelay / stats.rxPackets;
+        }
+        if (stats.jitterSamples > 0)
+        {
+            stats.meanJitter = stats.totalJitter / stats.jitterSamples;
+        }
+
         // 计算丢包率
         if (stats.txPackets > 0)
         {
@@ -115,26 +164,73 @@ StatisticsManager::PrintStats()
 Json::Value
 StatisticsManager::GenerateJsonReport()
 {
+    NodeStats swarm;
+    for (const auto& nodeStat : m_nodeStats)
+    {
+        swarm.txBytes += nodeStat.second.txBytes;
+        swarm.rxBytes += nodeStat.second.rxBytes;
+        swarm.txPackets += nodeStat.second.txPackets;
+        swarm.rxPackets += nodeStat.second.rxPackets;
+        swarm.lostPackets += nodeStat.second.lostPackets;
+        swarm.totalDelay += nodeStat.second.totalDelay;
+        swarm.totalJitter += nodeStat.second.totalJitter;
+        swarm.jitterSamples += nodeStat.second.jitterSamples;
+    }
+
     Json::Value report;
-    Json::Value nodeStats(Json::arrayValue);
+    report["nodes"] = static_cast<uint32_t>(m_nodeStats.size());
+    report["txPackets"] = swarm.txPackets;
+    report["rxPackets"] = swarm.rxPackets;
+    report["lostPackets"] = swarm.lostPackets;
+    report["txBytes"] = Json::UInt64(swarm.txBytes);
+    report["rxBytes"] = Json::UInt64(swarm.rxBytes);
+    report["packetLossRate"] =
+        swarm.txPackets > 0 ? static_cast<double>(swarm.lostPackets) / swarm.txPackets * 100.0
+                            : 0.0;
+    report["meanDelay"] = swarm.rxPackets > 0 ? swarm.totalDelay / swarm.rxPackets * 1000 : 0.0;
+    report["meanJitter"] =
+        swarm.jitterSamples > 0 ? swarm.totalJitter / swarm.jitterSamples * 1000 : 0.0;
+    return report;
+}
 
+void
+StatisticsManager::AddNodeTable(ResultsWriter& writer) const
+{
+    std::vector<uint32_t> nodeId;
+    std::vector<uint32_t> txPackets;
+    std::vector<uint32_t> rxPackets;
+    std::vector<uint32_t> lostPackets;
+    std::vector<uint64_t> txBytes;
+    std::vector<uint64_t> rxBytes;
+    std::vector<double> packetLossRate;
+    std::vector<double> meanDelay;
+    std::vector<double> meanJitter;
+    std::vector<double> throughput;
     for (const auto& nodeStat : m_nodeStats)
     {
-        Json::Value node;
-        node["nodeId"] = nodeStat.first;
-        node["txPackets"] = nodeStat.second.txPackets;
-        node["rxPackets"] = nodeStat.second.rxPackets;
-        node["lostPackets"] = nodeStat.second.lostPackets;
-        node["packetLossRate"] = nodeStat.second.packetLossRate;
-        node["meanDelay"] = nodeStat.second.meanDelay * 1000;   // 转换为毫秒
-        node["meanJitter"] = nodeStat.second.meanJitter * 1000; // 转换为毫秒
-        node["throughput"] = nodeStat.second.throughput;
-
-        nodeStats.append(node);
+        nodeId.push_back(nodeStat.first);
+        txPackets.push_back(nodeStat.second.txPackets);
+        rxPackets.push_back(nodeStat.second.rxPackets);
+        lostPackets.push_back(nodeStat.second.lostPackets);
+        txBytes.push_back(nodeStat.second.txBytes);
+        rxBytes.push_back(nodeStat.second.rxBytes);
+        packetLossRate.push_back(nodeStat.second.packetLossRate);
+        meanDelay.push_back(nodeStat.second.meanDelay * 1000);   // 转换为毫秒
+        meanJitter.push_back(nodeStat.second.meanJitter * 1000); // 转换为毫秒
+        throughput.push_back(nodeStat.second.throughput);
     }
 
-    report["nodeStats"] = nodeStats;
-    return report;
+    writer.BeginTable("nodes", nodeId.size());
+    writer.AddColumn("nodeId", nodeId);
+    writer.AddColumn("txPackets", txPackets);
+    writer.AddColumn("rxPackets", rxPackets);
+    writer.AddColumn("lostPackets", lostPackets);
+    writer.AddColumn("txBytes", txBytes);
+    writer.AddColumn("rxBytes", rxBytes);
+    writer.AddColumn("packetLossRate", packetLossRate);
+    writer.AddColumn("meanDelayMs", meanDelay);
+    writer.AddColumn("meanJitterMs", meanJitter);
+    writer.AddColumn("throughputMbps", throughput);
 }
 
 } // namespace ns3
\ No newline at end of file
@@ -1,6 +1,10 @@
 #ifndef STATISTICS_MANAGER_H
 #define STATISTICS_MANAGER_H
 
+#include "address-index.h"
+#include "app-statistics.h"
+#include "results-writer.h"
+
 #include "ns3/core-module.h"
 #include "ns3/flow-monitor-module.h"
 #include "ns3/internet-module.h"
@@ -23,7 +27,9 @@ struct NodeStats
     uint32_t lostPackets = 0;
 
     // 延迟统计
-    double totalDelay = 0.0;
+    double totalDelay = 0.0;  // seconds, summed over every received packet
+    double totalJitter = 0.0; // seconds, summed over every jitter sample
+    uint32_t jitterSamples = 0;
     double meanDelay = 0.0;
     double meanJitter = 0.0;
 
@@ -39,7 +45,11 @@ class StatisticsManager
     ~StatisticsManager();
 
     // 初始化方法
-    void Setup(Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier);
+    void Setup(Ptr<FlowMonitor> monitor,
+               Ptr<Ipv4FlowClassifier> classifier,
+               Ptr<const AddressIndex> addresses);
+    // Lean mode: per-node figures from the application layer counters, no FlowMonitor
+    void Setup(Ptr<const AppStatistics> statistics);
 
     // 收集统计信息
     void CollectStatistics();
@@ -47,18 +57,24 @@ class StatisticsManager
     // 打印统计信息
     void PrintStats();
 
-    // 生成JSON报告
+    // 生成JSON报告: swarm-wide totals, the per-node figures go to AddNodeTable()
     Json::Value GenerateJsonReport();
 
+    // Per-node statistics as the "nodes" table of a results file
+    void AddNodeTable(ResultsWriter& writer) const;
+
   private:
     // 将流统计聚合到节点统计
     void AggregateFlowStats();
+    void AggregateAppStats();
 
     // 计算每个节点的统计信息
     void CalculateNodeStats();
 
     Ptr<FlowMonitor> m_flowMonitor;
     Ptr<Ipv4FlowClassifier> m_classifier;
+    Ptr<const AddressIndex> m_addresses;
+    Ptr<const AppStatistics> m_appStatistics;
     std::map<uint32_t, NodeStats> m_nodeStats; // 节点ID -> 统计信息
 };
 
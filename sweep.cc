@@ -0,0 +1,129 @@
+#include "sweep.h"
+
+#include "options.h"
+
+#include "ns3/log.h"
+
+#include <fstream>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("Sweep");
+
+bool
+Sweep::IsShared(const std::string& name)
+{
+    // The traces, then what is loaded or written once for the whole sweep: the contact plan
+    // computed by the first point, the results file holding every point's tables and the
+    // profile of the whole process
+    return name == "nNodes" || name == "traceDir" || name == "scenario" ||
+           name == "loaderThreads" || name == "packetWindow" || name == "sweep" ||
+           name == "contactPlan" || name == "resultsFile" || name == "profileFile";
+}
+
+bool
+Sweep::Load(const std::string& filename)
+{
+    std::ifstream file(filename);
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    std::string error;
+    if (!file || !Json::parseFromStream(builder, file, &root, &error) || !root.isObject())
+    {
+        NS_LOG_ERROR("Unable to read sweep " << filename << ": " << error);
+        return false;
+    }
+
+    m_points.clear();
+    const Json::Value& points = root["points"];
+    if (points.isArray() && !points.empty())
+    {
+        for (const Json::Value& point : points)
+        {
+            m_points.push_back(point);
+        }
+    }
+    else
+    {
+        m_points.push_back(Json::Value(Json::objectValue));
+    }
+
+    // Cartesian product with the grid, one option at a time
+    const Json::Value& grid = root["grid"];
+    for (const std::string& name : grid.getMemberNames())
+    {
+        const Json::Value& values = grid[name];
+        if (!values.isArray() || values.empty())
+        {
+            NS_LOG_ERROR("Sweep grid values of " << name << " must be a non-empty array");
+            return false;
+        }
+        std::vector<Json::Value> combined;
+        for (const Json::Value& point : m_points)
+        {
+            for (const Json::Value& value : values)
+            {
+                combined.push_back(point);
+                combined.back()[name] = value;
+            }
+        }
+        m_points.swap(combined);
+    }
+
+    for (const Json::Value& point : m_points)
+    {
+        if (!point.isObject())
+        {
+            NS_LOG_ERROR("Sweep points must be objects of option values");
+            return false;
+        }
+        for (const std::string& name : point.getMemberNames())
+        {
+            if (IsShared(name))
+            {
+                NS_LOG_ERROR("Option " << name << " is shared by the sweep, it cannot vary");
+                return false;
+            }
+            // ns-3 global values and attribute defaults are not restored after a point, so
+            // they would leak into the following ones; unknown names would make the command
+            // line parser exit in the middle of the sweep
+            if (!SimulationOptions::IsOption(name))
+            {
+                NS_LOG_ERROR("Unknown option " << name << " in sweep " << filename);
+                return false;
+            }
+            if (!point[name].isConvertibleTo(Json::stringValue))
+            {
+                NS_LOG_ERROR("Sweep value of " << name << " must be a string, number or bool");
+                return false;
+            }
+        }
+    }
+    NS_LOG_INFO("Sweep " << filename << " has " << m_points.size() << " points");
+    return true;
+}
+
+uint32_t
+Sweep::GetNPoints() const
+{
+    return m_points.size();
+}
+
+const Json::Value&
+Sweep::GetSettings(uint32_t point) const
+{
+    return m_points[point];
+}
+
+std::vector<std::string>
+Sweep::GetArguments(uint32_t point) const
+{
+    std::vector<std::string> arguments;
+    for (const std::string& name : m_points[point].getMemberNames())
+    {
+        arguments.push_back("--" + name + "=" + m_points[point][name].asString());
+    }
+    return arguments;
+}
+
+} // namespace ns3
@@ -0,0 +1,44 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <json/json.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Configurations of a sweep over the same traces, read from a JSON file such as
+//
+//     {"points": [{"wifi": "80211ax"}, {"wifi": "80211n", "txPower": 20}],
+//      "grid": {"txPower": [10, 16, 20], "rxSensitivity": [-90, -80]}}
+//
+// Every point is combined with every combination of the grid values; without points the
+// grid alone is swept. Keys are command line option names, a configuration is the
+// command line of the run followed by "--name=value" for each of its settings. Options
+// that select or load the traces, and the contact plan, results and profile files, are
+// shared by the whole sweep and cannot vary; ns-3 attributes and global values such as
+// RngRun can only be set on the command line.
+class Sweep
+{
+  public:
+    // False, with the reason logged, if the file is missing or invalid
+    bool Load(const std::string& filename);
+
+    uint32_t GetNPoints() const;
+    // Settings of a point as a JSON object
+    const Json::Value& GetSettings(uint32_t point) const;
+    // Settings of a point as command line arguments
+    std::vector<std::string> GetArguments(uint32_t point) const;
+
+  private:
+    static bool IsShared(const std::string& name);
+
+    std::vector<Json::Value> m_points;
+};
+
+} // namespace ns3
+
+#endif // SWEEP_H
@@ -0,0 +1,707 @@
+#include "trace-loader.h"
+
+#include "binary-trace.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("TraceLoader");
+
+namespace
+{
+std::shared_ptr<MappedFile>
+MapFile(const std::string& filename)
+{
+    auto mapping = std::make_shared<MappedFile>();
+    return mapping->Open(filename) ? mapping : nullptr;
+}
+
+// Header of a binary trace with the given magic, or nullptr for a text file
+const BinaryTraceHeader*
+GetBinaryHeader(const MappedFile& mapping, const char* magic)
+{
+    if (mapping.GetSize() < sizeof(BinaryTraceHeader) ||
+        std::memcmp(mapping.GetData(), magic, 4) != 0)
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const BinaryTraceHeader*>(mapping.GetData());
+}
+
+// True if exactly count fixed-size records follow the header of a mapped binary trace.
+// Divides rather than multiplies, so a corrupt count cannot overflow into a match.
+bool
+HasRecords(const MappedFile& mapping, uint64_t headerSize, uint64_t recordSize, uint64_t count)
+{
+    uint64_t payload = mapping.GetSize() - headerSize;
+    return payload % recordSize == 0 && payload / recordSize == count;
+}
+
+// Binary keyframe times must be strictly increasing: positions are interpolated over,
+// and course changes scheduled by, the difference between consecutive times
+bool
+CheckTrack(const MobilityStore::Track& track, const std::string& filename, std::string& error)
+{
+    for (uint32_t k = 1; k < track.size; ++k)
+    {
+        if (track.time[k] <= track.time[k - 1])
+        {
+            error = "Keyframe times are not strictly increasing at keyframe " +
+                    std::to_string(k) + " of " + filename;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Binary packet records must be sorted by timestamp, as the stream sends them in order
+bool
+CheckPacketTraces(const PacketTraceList& traces, const std::string& filename, std::string& error)
+{
+    for (size_t i = 1; i < traces.size(); ++i)
+    {
+        if (traces[i].timestamp < traces[i - 1].timestamp)
+        {
+            error = "Packet trace records are not sorted by time at record " +
+                    std::to_string(i) + " of " + filename;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Node index destinations must name a node of the swarm
+bool
+CheckDestinations(const PacketTraceList& traces,
+                  uint32_t nNodes,
+                  const std::string& filename,
+                  std::string& error)
+{
+    for (size_t i = 0; i < traces.size(); ++i)
+    {
+        if ((traces[i].flags & PACKET_TRACE_NODE_INDEX) && traces[i].destination >= nNodes)
+        {
+            error = "Destination node " + std::to_string(traces[i].destination) +
+                    " of packet trace entry " + std::to_string(i) + " of " + filename +
+                    " is not one of the " + std::to_string(nNodes) + " nodes";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Records of a mapped binary packet trace, used in place
+bool
+GetBinaryPacketTrace(const std::shared_ptr<MappedFile>& mapping,
+                     const std::string& filename,
+                     PacketTraceList& traces,
+                     std::string& error)
+{
+    const BinaryTraceHeader* header = GetBinaryHeader(*mapping, BINARY_PACKET_TRACE_MAGIC);
+    uint64_t count = header->count;
+    if (header->version != BINARY_TRACE_VERSION ||
+        !HasRecords(*mapping, sizeof(BinaryTraceHeader), sizeof(PacketTrace), count))
+    {
+        error = "Unsupported or truncated binary packet trace file " + filename;
+        return false;
+    }
+    const PacketTrace* data =
+        reinterpret_cast<const PacketTrace*>(mapping->GetData() + sizeof(BinaryTraceHeader));
+    traces = PacketTraceList(mapping, data, count);
+    return CheckPacketTraces(traces, filename, error);
+}
+
+bool
+IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+void
+SkipBlanks(const char*& p, const char* end)
+{
+    while (p < end && IsBlank(*p))
+    {
+        ++p;
+    }
+}
+
+// Decimal number parser for the "%.3f"-style values found in the traces. Up to 15
+// significant digits the mantissa is exact, so a single division by an exact power of
+// ten gives the correctly rounded result, identical to strtod/iostream. Anything else
+// (exponents, long mantissas, inf/nan) falls back to strtod.
+bool
+ParseDouble(const char*& p, const char* end, double& value)
+{
+    static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    SkipBlanks(p, end);
+    const char* start = p;
+    const char* q = p;
+    bool negative = false;
+    if (q < end && (*q == '-' || *q == '+'))
+    {
+        negative = (*q == '-');
+        ++q;
+    }
+
+    bool anyDigit = false;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+    bool seenPoint = false;
+    for (; q < end; ++q)
+    {
+        if (*q >= '0' && *q <= '9')
+        {
+            anyDigit = true;
+            if (mantissa != 0 || *q != '0')
+            {
+                ++digits;
+            }
+            mantissa = mantissa * 10 + (*q - '0');
+            fractionDigits += seenPoint;
+            if (digits > 15)
+            {
+                break;
+            }
+        }
+        else if (*q == '.' && !seenPoint)
+        {
+            seenPoint = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (anyDigit && digits <= 15 && fractionDigits <= 22 && (q == end || IsBlank(*q)))
+    {
+        value = static_cast<double>(mantissa) / pow10[fractionDigits];
+        value = negative ? -value : value;
+        p = q;
+        return true;
+    }
+
+    // Slow path on a NUL-terminated copy of the token
+    const char* tokenEnd = start;
+    while (tokenEnd < end && !IsBlank(*tokenEnd))
+    {
+        ++tokenEnd;
+    }
+    std::string token(start, tokenEnd);
+    char* parsedEnd = nullptr;
+    value = std::strtod(token.c_str(), &parsedEnd);
+    if (token.empty() || parsedEnd != token.c_str() + token.size())
+    {
+        return false;
+    }
+    p = tokenEnd;
+    return true;
+}
+
+bool
+ParseUint32(const char*& p, const char* end, uint32_t& value)
+{
+    SkipBlanks(p, end);
+    const char* q = p;
+    uint64_t result = 0;
+    while (q < end && *q >= '0' && *q <= '9')
+    {
+        result = result * 10 + (*q - '0');
+        if (result > UINT32_MAX)
+        {
+            return false;
+        }
+        ++q;
+    }
+    if (q == p || (q < end && !IsBlank(*q)))
+    {
+        return false;
+    }
+    value = static_cast<uint32_t>(result);
+    p = q;
+    return true;
+}
+
+// Dotted-quad IPv4 address, returned in host byte order like Ipv4Address::Get()
+bool
+ParseIpv4(const char*& p, const char* end, uint32_t& address)
+{
+    SkipBlanks(p, end);
+    const char* q = p;
+    address = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i > 0)
+        {
+            if (q == end || *q != '.')
+            {
+                return false;
+            }
+            ++q;
+        }
+        uint32_t byte = 0;
+        const char* digits = q;
+        while (q < end && *q >= '0' && *q <= '9' && q - digits < 3)
+        {
+            byte = byte * 10 + (*q - '0');
+            ++q;
+        }
+        if (q == digits || byte > 255)
+        {
+            return false;
+        }
+        address = (address << 8) | byte;
+    }
+    if (q < end && !IsBlank(*q))
+    {
+        return false;
+    }
+    p = q;
+    return true;
+}
+
+// Call parseLine(begin, end) for every non-empty line and collect the rejected ones
+template <typename F>
+void
+ForEachLine(const MappedFile& content, const std::string& filename, std::string& error, F parseLine)
+{
+    uint32_t invalidLines = 0;
+    std::string firstInvalid;
+
+    const char* p = reinterpret_cast<const char*>(content.GetData());
+    const char* end = p + content.GetSize();
+    while (p < end)
+    {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        eol = eol ? eol : end;
+
+        const char* q = p;
+        SkipBlanks(q, eol);
+        if (q != eol && !parseLine(p, eol))
+        {
+            if (invalidLines++ == 0)
+            {
+                firstInvalid.assign(p, eol);
+            }
+        }
+        p = eol + 1;
+    }
+
+    if (invalidLines > 0)
+    {
+        error = std::to_string(invalidLines) + " invalid line(s) in trace file " + filename +
+                ", first: " + firstInvalid;
+    }
+}
+} // namespace
+
+TraceLoader::TraceLoader(const std::string& traceDir, uint32_t nNodes)
+    : m_traceDir(traceDir),
+      m_nNodes(nNodes),
+      m_packetWindow(0),
+      m_mobilityStore(Create<MobilityStore>())
+{
+    if (!m_traceDir.empty() && m_traceDir.back() != '/')
+    {
+        m_traceDir += '/';
+    }
+}
+
+std::string
+TraceLoader::GetMobilityTraceFilename(uint32_t node) const
+{
+    // return m_traceDir + "trace_node_" + std::to_string(node) + ".txt";
+    return m_traceDir + "trace_node_" + std::to_string(node);
+}
+
+std::string
+TraceLoader::GetPacketTraceFilename(uint32_t node) const
+{
+    // return m_traceDir + "packet_trace_node_" + std::to_string(node) + ".txt";
+    return m_traceDir + "packet_trace_node_" + std::to_string(node);
+}
+
+bool
+TraceLoader::ReadMobilityTrace(const std::string& filename,
+                               MobilityTrace& trace,
+                               std::string& error)
+{
+    std::shared_ptr<MappedFile> mapping = MapFile(filename);
+    if (!mapping)
+    {
+        error = "Unable to open trace file " + filename;
+        return false;
+    }
+
+    if (const BinaryTraceHeader* header = GetBinaryHeader(*mapping, BINARY_MOBILITY_TRACE_MAGIC))
+    {
+        uint64_t count = header->count;
+        uint64_t keyframeSize = sizeof(int64_t) + 3 * sizeof(float);
+        if (header->version != BINARY_TRACE_VERSION || count > UINT32_MAX ||
+            !HasRecords(*mapping, sizeof(BinaryTraceHeader), keyframeSize, count))
+        {
+            error = "Unsupported or truncated binary trace file " + filename;
+            return false;
+        }
+        const uint8_t* data = mapping->GetData() + sizeof(BinaryTraceHeader);
+        trace.track.time = reinterpret_cast<const int64_t*>(data);
+        trace.track.x = reinterpret_cast<const float*>(data + count * sizeof(int64_t));
+        trace.track.y = trace.track.x + count;
+        trace.track.z = trace.track.y + count;
+        trace.track.size = count;
+        trace.mapping = mapping;
+        return CheckTrack(trace.track, filename, error);
+    }
+
+    std::vector<MobilityStore::Keyframe>& keyframes = trace.keyframes;
+    ForEachLine(*mapping, filename, error, [&keyframes](const char* p, const char* end) {
+        double time;
+        double x;
+        double y;
+        double z;
+        if (!ParseDouble(p, end, time) || !ParseDouble(p, end, x) || !ParseDouble(p, end, y) ||
+            !ParseDouble(p, end, z))
+        {
+            return false;
+        }
+        keyframes.push_back({std::llround(time * 1e9),
+                             static_cast<float>(x),
+                             static_cast<float>(y),
+                             static_cast<float>(z)});
+        return true;
+    });
+    return true;
+}
+
+bool
+TraceLoader::ReadPacketTrace(const std::string& filename,
+                             PacketTraceList& traces,
+                             std::string& error)
+{
+    std::shared_ptr<MappedFile> mapping = MapFile(filename);
+    if (!mapping)
+    {
+        error = "Unable to open packet trace file " + filename;
+        return false;
+    }
+
+    if (GetBinaryHeader(*mapping, BINARY_PACKET_TRACE_MAGIC))
+    {
+        return GetBinaryPacketTrace(mapping, filename, traces, error);
+    }
+
+    std::vector<PacketTrace> parsed;
+    ForEachLine(*mapping, filename, error, [&parsed](const char* p, const char* end) {
+        PacketTrace trace;
+        if (!ParsePacketTraceLine(p, end, trace))
+        {
+            return false;
+        }
+        parsed.push_back(trace);
+        return true;
+    });
+    traces = PacketTraceList(std::move(parsed));
+    return true;
+}
+
+bool
+TraceLoader::ParsePacketTraceLine(const char* p, const char* end, PacketTrace& trace)
+{
+    double timestamp;
+    uint32_t size;
+    if (!ParseDouble(p, end, timestamp) || !ParseUint32(p, end, size) || size > UINT16_MAX)
+    {
+        return false;
+    }
+    // "#<index>" addresses a node by index instead of by IPv4 address
+    SkipBlanks(p, end);
+    if (p < end && *p == '#')
+    {
+        ++p;
+        if (!ParseUint32(p, end, trace.destination))
+        {
+            return false;
+        }
+        trace.flags = PACKET_TRACE_NODE_INDEX;
+    }
+    else
+    {
+        if (!ParseIpv4(p, end, trace.destination))
+        {
+            return false;
+        }
+        trace.flags = (trace.destination == 0xffffffff) ? PACKET_TRACE_BROADCAST : 0;
+    }
+    trace.timestamp = std::llround(timestamp * 1e9);
+    trace.size = size;
+    return true;
+}
+
+bool
+TraceLoader::OpenPacketTrace(const std::string& filename,
+                             uint32_t windowSize,
+                             uint32_t nNodes,
+                             PacketTraceStream& stream,
+                             std::string& error)
+{
+    PacketTraceList traces;
+    if (windowSize == 0)
+    {
+        if (!ReadPacketTrace(filename, traces, error) ||
+            !CheckDestinations(traces, nNodes, filename, error))
+        {
+            return false;
+        }
+        stream = PacketTraceStream(traces);
+        return true;
+    }
+
+    std::shared_ptr<MappedFile> mapping = MapFile(filename);
+    if (!mapping)
+    {
+        error = "Unable to open packet trace file " + filename;
+        return false;
+    }
+    if (GetBinaryHeader(*mapping, BINARY_PACKET_TRACE_MAGIC))
+    {
+        if (!GetBinaryPacketTrace(mapping, filename, traces, error) ||
+            !CheckDestinations(traces, nNodes, filename, error))
+        {
+            return false;
+        }
+        stream = PacketTraceStream(traces);
+        return true;
+    }
+    stream = PacketTraceStream(mapping, windowSize, nNodes, filename);
+    return true;
+}
+
+uint32_t
+TraceLoader::AddMobilityTrace(MobilityStore& store, MobilityTrace trace)
+{
+    if (trace.mapping)
+    {
+        return store.AddNode(trace.track, trace.mapping);
+    }
+    return store.AddNode(std::move(trace.keyframes));
+}
+
+bool
+TraceLoader::Load(uint32_t nThreads)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Job 2i parses the mobility trace of node i, job 2i+1 its packet trace
+    uint32_t nJobs = 2 * m_nNodes;
+    std::vector<MobilityTrace> mobilityTraces(m_nNodes);
+    std::vector<std::string> errors(nJobs);
+    std::vector<uint8_t> failed(nJobs, 0);
+    m_packetTraces.clear();
+    m_packetTraces.resize(m_nNodes);
+
+    std::atomic<uint32_t> nextJob(0);
+    auto worker = [&]() {
+        uint32_t job;
+        while ((job = nextJob.fetch_add(1)) < nJobs)
+        {
+            uint32_t node = job / 2;
+            if (job % 2 == 0)
+            {
+                failed[job] = !ReadMobilityTrace(GetMobilityTraceFilename(node),
+                                                 mobilityTraces[node],
+                                                 errors[job]);
+            }
+            else
+            {
+                failed[job] = !OpenPacketTrace(GetPacketTraceFilename(node),
+                                               m_packetWindow,
+                                               m_nNodes,
+                                               m_packetTraces[node],
+                                               errors[job]);
+            }
+        }
+    };
+
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nThreads = std::max(1u, std::min(nThreads, nJobs));
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < nThreads; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : workers)
+    {
+        t.join();
+    }
+
+    // Report in node order on the calling thread, independent of the worker schedule
+    bool ok = true;
+    for (uint32_t job = 0; job < nJobs; ++job)
+    {
+        if (!errors[job].empty())
+        {
+            NS_LOG_ERROR(errors[job]);
+        }
+        ok = ok && !failed[job];
+    }
+    if (!ok)
+    {
+        NS_LOG_ERROR("Unable to load the traces of " << m_traceDir);
+        return false;
+    }
+
+    uint64_t nKeyframes = 0;
+    uint64_t nPackets = 0;
+    uint32_t nStreamed = 0;
+    for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+        uint32_t node = AddMobilityTrace(*m_mobilityStore, std::move(mobilityTraces[i]));
+        uint32_t size = m_mobilityStore->GetTrack(node).size;
+        if (size == 0)
+        {
+            NS_LOG_ERROR("No valid entries found in trace file" << GetMobilityTraceFilename(i));
+        }
+        nKeyframes += size;
+        nPackets += m_packetTraces[i].GetSize();
+        nStreamed += m_packetTraces[i].IsWindowed();
+    }
+
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    NS_LOG_INFO("Loaded " << nKeyframes << " keyframes and " << nPackets
+                          << " packet traces for " << m_nNodes << " nodes in " << elapsed * 1000
+                          << " ms using " << nThreads << " thread(s)");
+    if (nStreamed > 0)
+    {
+        NS_LOG_INFO(nStreamed << " text packet trace file(s) are streamed in windows of "
+                              << m_packetWindow << " entries");
+    }
+    return true;
+}
+
+bool
+TraceLoader::LoadBundle(const std::string& filename)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::shared_ptr<MappedFile> mapping = MapFile(filename);
+    if (!mapping)
+    {
+        NS_LOG_ERROR("Unable to open scenario bundle " << filename);
+        return false;
+    }
+
+    const uint8_t* data = mapping->GetData();
+    uint64_t fileSize = mapping->GetSize();
+    const BundleHeader* header = reinterpret_cast<const BundleHeader*>(data);
+    if (fileSize < sizeof(BundleHeader) || std::memcmp(header->magic, SCENARIO_BUNDLE_MAGIC, 4) ||
+        header->version != BINARY_TRACE_VERSION ||
+        fileSize < sizeof(BundleHeader) + uint64_t(header->nNodes) * sizeof(BundleNodeEntry))
+    {
+        NS_LOG_ERROR("Unsupported or truncated scenario bundle " << filename);
+        return false;
+    }
+    if (header->nNodes < m_nNodes)
+    {
+        NS_LOG_ERROR("Scenario bundle " << filename << " only holds " << header->nNodes
+                                        << " nodes, " << m_nNodes << " requested");
+        return false;
+    }
+
+    const BundleNodeEntry* index =
+        reinterpret_cast<const BundleNodeEntry*>(data + sizeof(BundleHeader));
+    uint64_t keyframeSize = sizeof(int64_t) + 3 * sizeof(float);
+    uint64_t nKeyframes = 0;
+    uint64_t nPackets = 0;
+    m_packetTraces.clear();
+    m_packetTraces.resize(m_nNodes);
+    for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+        const BundleNodeEntry& entry = index[i];
+        if (entry.mobilityOffset % 8 != 0 || entry.packetOffset % 8 != 0 ||
+            entry.mobilityOffset > fileSize || entry.packetOffset > fileSize ||
+            entry.mobilityCount > UINT32_MAX ||
+            entry.mobilityCount > (fileSize - entry.mobilityOffset) / keyframeSize ||
+            entry.packetCount > (fileSize - entry.packetOffset) / sizeof(PacketTrace))
+        {
+            NS_LOG_ERROR("Corrupt index entry for node " << i << " in scenario bundle "
+                                                         << filename);
+            return false;
+        }
+
+        MobilityStore::Track track;
+        track.time = reinterpret_cast<const int64_t*>(data + entry.mobilityOffset);
+        track.x = reinterpret_cast<const float*>(track.time + entry.mobilityCount);
+        track.y = track.x + entry.mobilityCount;
+        track.z = track.y + entry.mobilityCount;
+        track.size = entry.mobilityCount;
+
+        PacketTraceList traces(mapping,
+                               reinterpret_cast<const PacketTrace*>(data + entry.packetOffset),
+                               entry.packetCount);
+        std::string section = filename + " (node " + std::to_string(i) + ")";
+        std::string error;
+        if (!CheckTrack(track, section, error) ||
+            !CheckPacketTraces(traces, section, error) ||
+            !CheckDestinations(traces, m_nNodes, section, error))
+        {
+            NS_LOG_ERROR(error);
+            return false;
+        }
+        m_mobilityStore->AddNode(track, mapping);
+        m_packetTraces[i] = PacketTraceStream(traces);
+
+        nKeyframes += entry.mobilityCount;
+        nPackets += entry.packetCount;
+    }
+
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    NS_LOG_INFO("Mapped " << nKeyframes << " keyframes and " << nPackets << " packet traces for "
+                          << m_nNodes << " of " << header->nNodes << " nodes from " << filename
+                          << " in " << elapsed * 1000 << " ms");
+    return true;
+}
+
+Ptr<MobilityStore>
+TraceLoader::GetMobilityStore() const
+{
+    return m_mobilityStore;
+}
+
+void
+TraceLoader::SetPacketTraceWindow(uint32_t windowSize)
+{
+    m_packetWindow = windowSize;
+}
+
+PacketTraceStream
+TraceLoader::GetPacketTraces(uint32_t node) const
+{
+    NS_ASSERT(node < m_packetTraces.size());
+    PacketTraceStream stream = m_packetTraces[node].Rewind();
+    // The stored stream is never advanced, so the rewound one starts with the same entries
+    NS_ASSERT(stream.AtEnd() == m_packetTraces[node].AtEnd());
+    return stream;
+}
+
+} // namespace ns3
@@ -0,0 +1,92 @@
+#ifndef TRACE_LOADER_H
+#define TRACE_LOADER_H
+
+#include "mapped-file.h"
+#include "mobility-store.h"
+#include "packet-trace-stream.h"
+#include "packet-trace.h"
+
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Reads the mobility ("trace_node_X") and packet ("packet_trace_node_X") traces of a
+// whole swarm. Files are parsed on a pool of worker threads, the results are then
+// assembled in node order, so the outcome does not depend on the number of threads.
+// Each file is memory-mapped and may be either text or binary (see binary-trace.h);
+// binary traces are used in place without copying. Text packet traces can be streamed
+// instead of parsed up front (see SetPacketTraceWindow).
+class TraceLoader
+{
+  public:
+    // Contents of one mobility trace: a view into a mapped binary trace, or keyframes
+    // parsed from text
+    struct MobilityTrace
+    {
+        std::shared_ptr<MappedFile> mapping;
+        MobilityStore::Track track;
+        std::vector<MobilityStore::Keyframe> keyframes;
+    };
+
+    TraceLoader(const std::string& traceDir, uint32_t nNodes);
+
+    // Stream text packet traces in windows of windowSize entries instead of reading them
+    // whole; 0 (the default) reads them up front. Must be called before Load().
+    void SetPacketTraceWindow(uint32_t windowSize);
+
+    // Parse all trace files; nThreads == 0 uses one worker per hardware thread. Returns
+    // false, with the reasons logged, if a file is missing or invalid.
+    bool Load(uint32_t nThreads);
+    // Map the traces of the first nNodes nodes from a scenario bundle instead of loose
+    // files. Only the sections of those nodes are ever read. Returns false on error.
+    bool LoadBundle(const std::string& filename);
+
+    Ptr<MobilityStore> GetMobilityStore() const;
+    // A stream over the packet trace of a node from its first entry; the loaded trace is
+    // kept, so every run of a sweep reads the same data without loading it again
+    PacketTraceStream GetPacketTraces(uint32_t node) const;
+
+    std::string GetMobilityTraceFilename(uint32_t node) const;
+    std::string GetPacketTraceFilename(uint32_t node) const;
+
+    // Single-file readers, returning false (with a message in error) if the file cannot be
+    // read or a binary file is invalid: truncated, keyframe times not strictly increasing
+    // or packet records not sorted by time. Malformed text lines are skipped and reported
+    // in error as well.
+    static bool ReadMobilityTrace(const std::string& filename,
+                                  MobilityTrace& trace,
+                                  std::string& error);
+    static bool ReadPacketTrace(const std::string& filename,
+                                PacketTraceList& traces,
+                                std::string& error);
+    // Like ReadPacketTrace, but a text trace is parsed lazily, windowSize entries at a
+    // time (0 reads it whole), and node index destinations must be below nNodes. Invalid
+    // lines are logged as the stream reaches them.
+    static bool OpenPacketTrace(const std::string& filename,
+                                uint32_t windowSize,
+                                uint32_t nNodes,
+                                PacketTraceStream& stream,
+                                std::string& error);
+    // Parse one "<time> <size> <destination>" text line
+    static bool ParsePacketTraceLine(const char* p, const char* end, PacketTrace& trace);
+
+    // Append a trace returned by ReadMobilityTrace as the next node of store
+    static uint32_t AddMobilityTrace(MobilityStore& store, MobilityTrace trace);
+
+  private:
+    std::string m_traceDir;
+    uint32_t m_nNodes;
+    uint32_t m_packetWindow;
+    Ptr<MobilityStore> m_mobilityStore;
+    std::vector<PacketTraceStream> m_packetTraces;
+};
+
+} // namespace ns3
+
+#endif // TRACE_LOADER_H
@@ -0,0 +1,140 @@
+"""
+Convert text traces to the binary trace format read by NS-FLS (see binary-trace.h).
+
+    python3 convert_traces.py <input_dir> <output_dir>
+
+Every trace_node_X / packet_trace_node_X file of input_dir is written under the same
+name to output_dir. Run the simulation with --traceDir=<output_dir>; binary traces are
+memory-mapped and used in place, text traces keep working as before.
+
+Mobility ("FLSM"): header, int64 times in ns, then float32 x[], y[], z[] arrays.
+Packet ("FLST"): header, then 16-byte records (int64 time ns, uint32 destination,
+uint16 size, uint16 flags). The destination is an IPv4 address in host byte order, or a
+node index when written as "#<index>" in the text trace.
+"""
+import math
+import os
+import re
+import struct
+import sys
+
+VERSION = 1
+FLAG_BROADCAST = 0x1
+FLAG_NODE_INDEX = 0x2
+
+
+def to_nanoseconds(seconds):
+    # Same rounding as std::llround(seconds * 1e9) in the C++ text parser
+    value = seconds * 1e9
+    floor = math.floor(abs(value))
+    rounded = floor + 1 if abs(value) - floor >= 0.5 else floor
+    return int(math.copysign(rounded, value))
+
+
+def parse_ipv4(text):
+    parts = [int(p) for p in text.split(".")]
+    if len(parts) != 4 or any(p < 0 or p > 255 for p in parts):
+        raise ValueError(f"invalid IPv4 address: {text}")
+    return (parts[0] << 24) | (parts[1] << 16) | (parts[2] << 8) | parts[3]
+
+
+def read_mobility(src):
+    """Keyframes of a text or binary mobility trace as (times_ns, xs, ys, zs), sorted by time"""
+    with open(src, "rb") as f:
+        data = f.read()
+    if data[:4] == b"FLSM":
+        count = struct.unpack_from("<Q", data, 8)[0]
+        times = list(struct.unpack_from(f"<{count}q", data, 16))
+        coords = struct.unpack_from(f"<{3 * count}f", data, 16 + 8 * count)
+        return times, coords[:count], coords[count : 2 * count], coords[2 * count :]
+
+    keyframes = {}
+    for line in data.decode().splitlines():
+        fields = line.split()
+        if len(fields) < 4:
+            continue
+        # Later duplicates of a timestamp win, like the simulator's text loader
+        keyframes[to_nanoseconds(float(fields[0]))] = [float(v) for v in fields[1:4]]
+    times = sorted(keyframes)
+    return tuple([times] + [[keyframes[t][axis] for t in times] for axis in range(3)])
+
+
+def read_packets(src):
+    """Records (time_ns, destination, size, flags) of a text or binary packet trace"""
+    with open(src, "rb") as f:
+        data = f.read()
+    if data[:4] == b"FLST":
+        count = struct.unpack_from("<Q", data, 8)[0]
+        return [struct.unpack_from("<qIHH", data, 16 + 16 * i) for i in range(count)]
+
+    records = []
+    for line in data.decode().splitlines():
+        fields = line.split()
+        if len(fields) < 3:
+            continue
+        time = to_nanoseconds(float(fields[0]))
+        size = int(fields[1])
+        if size > 0xFFFF:
+            raise ValueError(f"{src}: packet size {size} does not fit the binary format")
+        if fields[2].startswith("#"):
+            destination, flags = int(fields[2][1:]), FLAG_NODE_INDEX
+        else:
+            destination = parse_ipv4(fields[2])
+            flags = FLAG_BROADCAST if destination == 0xFFFFFFFF else 0
+        records.append((time, destination, size, flags))
+
+    # Stable sort keeps the order of entries sharing a timestamp
+    records.sort(key=lambda r: r[0])
+    return records
+
+
+def pack_mobility(times, xs, ys, zs):
+    """Keyframe arrays without header: int64 times, then float32 x, y and z"""
+    count = len(times)
+    return struct.pack(f"<{count}q", *times) + b"".join(
+        struct.pack(f"<{count}f", *axis) for axis in (xs, ys, zs)
+    )
+
+
+def pack_packets(records):
+    return b"".join(struct.pack("<qIHH", *record) for record in records)
+
+
+def convert_mobility(src, dst):
+    times, xs, ys, zs = read_mobility(src)
+    with open(dst, "wb") as f:
+        f.write(struct.pack("<4sIQ", b"FLSM", VERSION, len(times)))
+        f.write(pack_mobility(times, xs, ys, zs))
+    return len(times)
+
+
+def convert_packets(src, dst):
+    records = read_packets(src)
+    with open(dst, "wb") as f:
+        f.write(struct.pack("<4sIQ", b"FLST", VERSION, len(records)))
+        f.write(pack_packets(records))
+    return len(records)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+    input_dir, output_dir = sys.argv[1], sys.argv[2]
+    os.makedirs(output_dir, exist_ok=True)
+
+    pattern = re.compile(r"^(packet_)?trace_node_\d+(\.txt)?$")
+    for name in sorted(os.listdir(input_dir)):
+        if not pattern.match(name):
+            continue
+        src = os.path.join(input_dir, name)
+        dst = os.path.join(output_dir, name.removesuffix(".txt"))
+        if name.startswith("packet_"):
+            count = convert_packets(src, dst)
+        else:
+            count = convert_mobility(src, dst)
+        print(f"Converted {name}: {count} entries")
+
+
+if __name__ == "__main__":
+    main()
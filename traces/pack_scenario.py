@@ -0,0 +1,70 @@
+"""
+Pack a trace directory into a single indexed scenario bundle (see binary-trace.h).
+
+    python3 pack_scenario.py <trace_dir> <bundle_file> [num_nodes]
+
+trace_dir may hold text or binary traces (trace_node_X / packet_trace_node_X). Nodes
+are packed from 0 up to num_nodes - 1, or until the first node without a mobility
+trace. A missing packet trace is packed as an empty one. Run the simulation with
+--scenario=<bundle_file>; it only maps the sections of the nodes it instantiates.
+
+Layout: 16-byte header ("FLSB", version, node count), then one 32-byte index entry per
+node (mobility offset and keyframe count, packet offset and record count), then the
+mobility and packet sections in the binary trace layouts, each aligned to 8 bytes.
+"""
+import os
+import struct
+import sys
+
+from convert_traces import VERSION, pack_mobility, pack_packets, read_mobility, read_packets
+
+
+def find_trace(trace_dir, name):
+    for candidate in (name, name + ".txt"):
+        path = os.path.join(trace_dir, candidate)
+        if os.path.exists(path):
+            return path
+    return None
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        print(__doc__)
+        sys.exit(1)
+    trace_dir, bundle_file = sys.argv[1], sys.argv[2]
+    max_nodes = int(sys.argv[3]) if len(sys.argv) == 4 else None
+
+    sections = []
+    while max_nodes is None or len(sections) < max_nodes:
+        node = len(sections)
+        mobility_file = find_trace(trace_dir, f"trace_node_{node}")
+        if mobility_file is None:
+            break
+        mobility = read_mobility(mobility_file)
+        packet_file = find_trace(trace_dir, f"packet_trace_node_{node}")
+        packets = read_packets(packet_file) if packet_file else []
+        sections.append(
+            (len(mobility[0]), pack_mobility(*mobility), len(packets), pack_packets(packets))
+        )
+
+    offset = 16 + 32 * len(sections)
+    index = []
+    for keyframes, mobility, records, packets in sections:
+        mobility_offset = offset
+        packet_offset = mobility_offset + (len(mobility) + 7) // 8 * 8
+        offset = packet_offset + len(packets)
+        index.append(struct.pack("<QQQQ", mobility_offset, keyframes, packet_offset, records))
+
+    with open(bundle_file, "wb") as f:
+        f.write(struct.pack("<4sII4x", b"FLSB", VERSION, len(sections)))
+        f.write(b"".join(index))
+        for _, mobility, _, packets in sections:
+            f.write(mobility)
+            f.write(b"\0" * (-len(mobility) % 8))
+            f.write(packets)
+
+    print(f"Packed {len(sections)} nodes into {bundle_file} ({offset} bytes)")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,5 +1,8 @@
 #include "traffic-controller.h"
 
+#include "hot-trace.h"
+#include "trace-loader.h"
+
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 
@@ -10,6 +13,29 @@ NS_LOG_COMPONENT_DEFINE("FLSApplication");
 
 NS_OBJECT_ENSURE_REGISTERED(FLSApplication);
 
+namespace
+{
+const char*
+GetErrorString(Socket::SocketErrno error)
+{
+    switch (error)
+    {
+    case Socket::ERROR_NOTERROR:
+        return "No error";
+    case Socket::ERROR_ISCONN:
+        return "Socket is connected";
+    case Socket::ERROR_NOTCONN:
+        return "Socket is not connected";
+    case Socket::ERROR_MSGSIZE:
+        return "Message too long";
+    case Socket::ERROR_INVAL:
+        return "Invalid argument";
+    default:
+        return "Unknown error";
+    }
+}
+} // namespace
+
 TypeId
 FLSApplication::GetTypeId(void)
 {
@@ -26,14 +52,22 @@ FLSApplication::GetTypeId(void)
                                           "Size of packets sent",
                                           UintegerValue(1024),
                                           MakeUintegerAccessor(&FLSApplication::m_packetSize),
-                                          MakeUintegerChecker<uint32_t>(1));
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("TraceWindow",
+                                          "Text packet trace entries parsed ahead by "
+                                          "SetupTraceFile (0: read the whole trace)",
+                                          UintegerValue(256),
+                                          MakeUintegerAccessor(&FLSApplication::m_traceWindow),
+                                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 FLSApplication::FLSApplication()
     : m_socket(0),
       m_packetsSent(0),
-      m_packetsReceived(0)
+      m_packetsReceived(0),
+      m_currentTraceIndex(0),
+      m_sequence(0)
 {
 }
 
@@ -54,8 +88,9 @@ FLSApplication::StartApplication(void)
         InetSocketAddress local = InetSocketAddress(Ipv4Address::GetAny(), 9);
         m_socket->Bind(local);
         m_socket->SetRecvCallback(MakeCallback(&FLSApplication::ReceivePacket, this));
+        m_socket->SetAllowBroadcast(true);
     }
-    if (!m_packetTraces.empty())
+    if (!m_packetTraces.AtEnd())
     {
         // ScheduleNextPacket();
         Simulator::Schedule(Seconds(1.0), &FLSApplication::ScheduleNextPacket, this);
@@ -79,94 +114,24 @@ FLSApplication::StopApplication(void)
 void
 FLSApplication::SendPacket(void)
 {
-    Ptr<MobilityModel> mobility = GetNode()->GetObject<MobilityModel>();
-    // Vector myPos = mobility->GetPosition();
-
-    if (!m_packetTraces.empty())
+    if (!m_packetTraces.AtEnd())
     {
-        const PacketTrace& trace = m_packetTraces[m_currentTraceIndex];
-        Ptr<Packet> packet = Create<Packet>(trace.size);
-
-        Time now = Simulator::Now();
-        m_stats.sentPackets++;
-        m_stats.sentBytes += trace.size;
-
-        if (m_stats.firstSentTime == Seconds(0))
-        {
-            m_stats.firstSentTime = now;
-        }
-        m_stats.lastSentTime = now;
-
-        Ipv4Address destAddr(trace.destination.c_str());
-        bool isBroadCast = (trace.destination == "255.255.255.255");
-
         if (!m_socket)
         {
             NS_LOG_ERROR("Socket is null");
             return;
         }
 
-        if (isBroadCast)
-        {
-            m_socket->SetAllowBroadcast(true);
-            InetSocketAddress broadcast = InetSocketAddress(Ipv4Address::GetBroadcast(), 9);
-            int ret = m_socket->SendTo(packet, 0, broadcast);
-            if (ret == -1)
-            {
-                NS_LOG_ERROR("Error broadcasting packet: " << m_socket->GetErrno());
-            }
-            else
-            {
-                // NS_LOG_INFO("APP LAYER: " << Simulator::Now().GetSeconds() << "s\t"
-                //                           << "Node " << GetNode()->GetId() << "\tBroadcast\t"
-                //                           << trace.size << " bytes"
-                //                           << "\tPacketID: " << packet->GetUid());
-                m_packetsSent++;
-            }
-        }
-        else
-        {
-            InetSocketAddress remote = InetSocketAddress(destAddr, 9);
-            int ret = m_socket->SendTo(packet, 0, remote);
-            if (ret == -1)
-            {
-                NS_LOG_ERROR("Error broadcasting packet: " << m_socket->GetErrno());
-            }
-            else
-            {
-                // NS_LOG_INFO("APP LAYER: " << Simulator::Now().GetSeconds() << "s\t"
-                //                           << "Node " << GetNode()->GetId() << "\tUniCast\t"
-                //                           << trace.size << " bytes"
-                //                           << "\tPacketID: " << packet->GetUid());
-                m_packetsSent++;
-            }
-        }
-
-        // NS_LOG_INFO("Socket state after send: " << m_socket->GetErrno());
-
-        switch (m_socket->GetErrno())
+        // Traces are bursty: one event sends every entry that is due by now, in trace order
+        Time now = Simulator::Now();
+        do
         {
-        case Socket::ERROR_NOTERROR:
-            NS_LOG_ERROR("No error");
-            break;
-        case Socket::ERROR_ISCONN:
-            NS_LOG_ERROR("Socket is connected");
-            break;
-        case Socket::ERROR_NOTCONN:
-            NS_LOG_ERROR("Socket is not connected");
-            break;
-        case Socket::ERROR_MSGSIZE:
-            NS_LOG_ERROR("Message too long");
-            break;
-        case Socket::ERROR_INVAL:
-            NS_LOG_ERROR("Invalid argument");
-            break;
-        default:
-            NS_LOG_ERROR("Unknown error");
-            break;
-        }
+            SendTraceEntry(m_packetTraces.Peek());
+            m_packetTraces.Next();
+            m_currentTraceIndex++;
+        } while (!m_packetTraces.AtEnd() &&
+                 m_traceStart + NanoSeconds(m_packetTraces.Peek().timestamp) <= now);
 
-        m_currentTraceIndex++;
         ScheduleNextPacket();
     }
 
@@ -197,6 +162,89 @@ FLSApplication::SendPacket(void)
     }
 }
 
+void
+FLSApplication::SendTraceEntry(const PacketTrace& trace)
+{
+    // The payload is a virtual zero area: no payload bytes are allocated or zeroed, and
+    // the buffer block comes from ns-3's recycling free list. Packets are not pooled
+    // because every send must get a fresh uid. The FlsHeader is part of the traced size.
+    uint32_t headerSize = FlsHeader::SERIALIZED_SIZE;
+    Ptr<Packet> packet = Create<Packet>(trace.size > headerSize ? trace.size - headerSize : 0);
+
+    Time now = Simulator::Now();
+    m_stats.sentPackets++;
+    m_stats.sentBytes += packet->GetSize() + headerSize;
+
+    if (m_stats.firstSentTime == Seconds(0))
+    {
+        m_stats.firstSentTime = now;
+    }
+    m_stats.lastSentTime = now;
+
+    Ipv4Address destAddr(trace.destination);
+    if ((trace.flags & PACKET_TRACE_NODE_INDEX) && m_addresses)
+    {
+        destAddr = m_addresses->GetAddress(trace.destination);
+    }
+    else if (trace.flags & PACKET_TRACE_NODE_INDEX)
+    {
+        Ptr<Ipv4> ipv4 = NodeList::GetNode(trace.destination)->GetObject<Ipv4>();
+        destAddr = ipv4->GetAddress(1, 0).GetLocal();
+    }
+    bool isBroadCast = (trace.flags & PACKET_TRACE_BROADCAST);
+    FlsHeader header;
+    header.SetSource(GetNode()->GetId());
+    header.SetSequence(m_sequence++);
+    header.SetSendTime(now);
+    header.SetUnicast(!isBroadCast);
+    packet->AddHeader(header);
+    if (m_statistics)
+    {
+        m_statistics->NotifySent(GetNode()->GetId(), packet->GetSize(), !isBroadCast);
+    }
+    if (m_appStatistics)
+    {
+        m_appStatistics->NotifySent(GetNode()->GetId(), packet->GetSize(), !isBroadCast);
+    }
+
+    if (isBroadCast)
+    {
+        InetSocketAddress broadcast = InetSocketAddress(Ipv4Address::GetBroadcast(), 9);
+        int ret = m_socket->SendTo(packet, 0, broadcast);
+        if (ret == -1)
+        {
+            NS_LOG_ERROR("Error broadcasting packet: " << GetErrorString(m_socket->GetErrno()));
+        }
+        else
+        {
+            // NS_LOG_INFO("APP LAYER: " << Simulator::Now().GetSeconds() << "s\t"
+            //                           << "Node " << GetNode()->GetId() << "\tBroadcast\t"
+            //                           << trace.size << " bytes"
+            //                           << "\tPacketID: " << packet->GetUid());
+            m_packetsSent++;
+        }
+    }
+    else
+    {
+        InetSocketAddress remote = InetSocketAddress(destAddr, 9);
+        int ret = m_socket->SendTo(packet, 0, remote);
+        if (ret == -1)
+        {
+            NS_LOG_ERROR("Error sending packet: " << GetErrorString(m_socket->GetErrno()));
+        }
+        else
+        {
+            // NS_LOG_INFO("APP LAYER: " << Simulator::Now().GetSeconds() << "s\t"
+            //                           << "Node " << GetNode()->GetId() << "\tUniCast\t"
+            //                           << trace.size << " bytes"
+            //                           << "\tPacketID: " << packet->GetUid());
+            m_packetsSent++;
+        }
+    }
+
+    FLS_HOT_TRACE_EVENT(APP_TX, GetNode()->GetId(), packet->GetUid(), packet->GetSize());
+}
+
 void
 FLSApplication::ReceivePacket(Ptr<Socket> socket)
 {
@@ -214,6 +262,22 @@ FLSApplication::ReceivePacket(Ptr<Socket> socket)
             m_stats.firstReceivedTime = now;
         }
         m_stats.lastReceivedTime = now;
+        FLS_HOT_TRACE_EVENT(APP_RX, GetNode()->GetId(), packet->GetUid(), packet->GetSize());
+
+        FlsHeader header;
+        if (packet->GetSize() >= FlsHeader::SERIALIZED_SIZE)
+        {
+            packet->PeekHeader(header);
+            m_latency.Record(now - header.GetSendTime());
+            if (m_statistics)
+            {
+                m_statistics->NotifyReceived(GetNode()->GetId(), packet->GetSize(), header);
+            }
+            if (m_appStatistics)
+            {
+                m_appStatistics->NotifyReceived(GetNode()->GetId(), packet->GetSize(), header);
+            }
+        }
 
         // NS_LOG_INFO("Node " << GetNode()->GetId() << " received packet from "
         //                     << InetSocketAddress::ConvertFrom(from).GetIpv4() << " at time "
@@ -245,49 +309,67 @@ FLSApplication::GetPacketsReceived(void) const
 void
 FLSApplication::SetupTraceFile(const std::string& filename)
 {
-    std::ifstream file(filename);
-    if (!file.is_open())
+    PacketTraceStream traces;
+    std::string error;
+    TraceLoader::OpenPacketTrace(filename, m_traceWindow, NodeList::GetNNodes(), traces, error);
+    if (!error.empty())
     {
-        NS_LOG_ERROR("Unable to open packet trace file" << filename);
-        return;
+        NS_LOG_ERROR(error);
     }
-
-    std::string line;
-    while (std::getline(file, line))
+    if (traces.IsWindowed())
     {
-        std::istringstream iss(line);
-        PacketTrace trace;
-        if (!(iss >> trace.timestamp >> trace.size >> trace.destination))
-        {
-            NS_LOG_ERROR("Error parsing trace file line:" << line);
-            continue;
-        }
-        m_packetTraces.push_back(trace);
-        NS_LOG_INFO("Loaded trace: " << trace.timestamp << "s, " << trace.size
-                                     << " bytes, To: " << trace.destination);
+        NS_LOG_INFO("Streaming packet traces from " << filename);
+    }
+    else
+    {
+        NS_LOG_INFO("Loaded " << traces.GetSize() << " packet traces from " << filename);
     }
-    NS_LOG_INFO("Loaded " << m_packetTraces.size() << " packet traces from " << filename);
+    SetPacketTraces(std::move(traces));
+}
+
+void
+FLSApplication::SetPacketTraces(PacketTraceStream traces)
+{
+    m_packetTraces = std::move(traces);
     m_currentTraceIndex = 0;
 }
 
+void
+FLSApplication::SetAddressIndex(Ptr<const AddressIndex> addresses)
+{
+    m_addresses = addresses;
+}
+
+void
+FLSApplication::SetStatistics(Ptr<WindowedStatistics> statistics)
+{
+    m_statistics = statistics;
+}
+
+void
+FLSApplication::SetAppStatistics(Ptr<AppStatistics> statistics)
+{
+    m_appStatistics = statistics;
+}
+
 void
 FLSApplication::ScheduleNextPacket()
 {
-    if (m_currentTraceIndex >= m_packetTraces.size())
+    if (m_packetTraces.AtEnd())
     {
         NS_LOG_ERROR("All packets from this trace file have been sent.");
         return;
     }
-    Time tNext;
     if (m_currentTraceIndex == 0)
     {
-        tNext = Seconds(m_packetTraces[m_currentTraceIndex].timestamp);
+        m_traceStart = Simulator::Now();
     }
-    else
+    // Trace timestamps are absolute offsets from the trace start, so rounding never
+    // accumulates; an entry that is already due (unsorted trace) is sent right away
+    Time tNext = m_traceStart + NanoSeconds(m_packetTraces.Peek().timestamp) - Simulator::Now();
+    if (tNext.IsStrictlyNegative())
     {
-        double timeDiff = m_packetTraces[m_currentTraceIndex].timestamp -
-                          m_packetTraces[m_currentTraceIndex - 1].timestamp;
-        tNext = Seconds(timeDiff);
+        tNext = Seconds(0);
     }
     m_sendEvent = Simulator::Schedule(tNext, &FLSApplication::SendPacket, this);
 }
@@ -1,7 +1,12 @@
 #ifndef FLS_APPLICATION_H
 #define FLS_APPLICATION_H
 
-#include "packet-trace.h"
+#include "address-index.h"
+#include "app-statistics.h"
+#include "fls-header.h"
+#include "latency-histogram.h"
+#include "packet-trace-stream.h"
+#include "windowed-statistics.h"
 
 #include "ns3/application.h"
 #include "ns3/internet-module.h"
@@ -24,6 +29,14 @@ class FLSApplication : public Application
     uint32_t GetPacketsSent(void) const;
     uint32_t GetPacketsReceived(void) const;
     void SetupTraceFile(const std::string& filename);
+    // Use an already opened packet trace
+    void SetPacketTraces(PacketTraceStream traces);
+    // Resolve node index destinations through the swarm's address index
+    void SetAddressIndex(Ptr<const AddressIndex> addresses);
+    // Report every sent and received packet to a windowed sampler
+    void SetStatistics(Ptr<WindowedStatistics> statistics);
+    // Report them to the lean per-node counters as well
+    void SetAppStatistics(Ptr<AppStatistics> statistics);
 
     struct TrafficStats
     {
@@ -58,12 +71,20 @@ class FLSApplication : public Application
         return m_stats;
     }
 
+    // One-way latency of every packet this node received
+    const LatencyHistogram& GetLatency() const
+    {
+        return m_latency;
+    }
+
   private:
     TrafficStats m_stats;
+    LatencyHistogram m_latency;
     virtual void StartApplication(void);
     virtual void StopApplication(void);
 
     void SendPacket();
+    void SendTraceEntry(const PacketTrace& trace);
     void ScheduleNextPacket();
     void ReceivePacket(Ptr<Socket> socket);
     double CalculateDistance(Vector a, Vector b);
@@ -73,8 +94,14 @@ class FLSApplication : public Application
     uint32_t m_packetSize;
     uint32_t m_packetsSent;
     uint32_t m_packetsReceived;
-    std::vector<PacketTrace> m_packetTraces;
+    uint32_t m_traceWindow;
+    PacketTraceStream m_packetTraces;
+    Ptr<const AddressIndex> m_addresses;
+    Ptr<WindowedStatistics> m_statistics;
+    Ptr<AppStatistics> m_appStatistics;
     uint32_t m_currentTraceIndex;
+    uint32_t m_sequence; // FlsHeader sequence number of the next packet
+    Time m_traceStart; // simulation time that trace timestamp 0 maps to
     EventId m_sendEvent;
 };
 
@@ -0,0 +1,244 @@
+#include "windowed-statistics.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("WindowedStatistics");
+
+namespace
+{
+struct WindowedStatisticsHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nNodes;
+    uint32_t graceWindows;
+    int64_t window; // nanoseconds
+    int64_t start;  // nanoseconds
+};
+
+static_assert(sizeof(WindowedStatisticsHeader) == 32,
+              "WindowedStatisticsHeader must be 32 bytes");
+static_assert(sizeof(WindowedStatistics::NodeWindow) == 48,
+              "NodeWindow records must be 48 bytes");
+
+const char WINDOWED_STATISTICS_MAGIC[4] = {'F', 'L', 'S', 'W'};
+const uint32_t WINDOWED_STATISTICS_VERSION = 1;
+} // namespace
+
+WindowedStatistics::WindowedStatistics(uint32_t nNodes, Time window, Time grace)
+    : m_nNodes(nNodes),
+      m_window(window),
+      m_graceWindows((grace.GetNanoSeconds() + window.GetNanoSeconds() - 1) /
+                     window.GetNanoSeconds()),
+      m_nextToWrite(0),
+      m_totals(nNodes, NodeWindow{}),
+      m_peakRxBytes(0),
+      m_peakWindow(0)
+{
+    NS_ASSERT(window.IsStrictlyPositive());
+    // The windows within the grace period, the current one and the next one, which
+    // events at a window boundary may already reach before CloseWindow() runs
+    m_slots.assign(m_graceWindows + 3, std::vector<NodeWindow>(nNodes, NodeWindow{}));
+    m_delivered.assign(m_graceWindows + 3, std::vector<uint32_t>(nNodes, 0));
+}
+
+bool
+WindowedStatistics::Open(const std::string& filename)
+{
+    m_file.open(filename, std::ios::binary);
+    if (!m_file)
+    {
+        NS_LOG_ERROR("Unable to write windowed statistics file " << filename);
+        return false;
+    }
+    return true;
+}
+
+void
+WindowedStatistics::Start()
+{
+    m_start = Simulator::Now();
+    if (m_file.is_open())
+    {
+        WindowedStatisticsHeader header;
+        std::memcpy(header.magic, WINDOWED_STATISTICS_MAGIC, 4);
+        header.version = WINDOWED_STATISTICS_VERSION;
+        header.nNodes = m_nNodes;
+        header.graceWindows = m_graceWindows;
+        header.window = m_window.GetNanoSeconds();
+        header.start = m_start.GetNanoSeconds();
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    m_closeEvent = Simulator::Schedule(m_window, &WindowedStatistics::CloseWindow, this);
+}
+
+uint64_t
+WindowedStatistics::GetWindowIndex(Time t) const
+{
+    return (t - m_start).GetNanoSeconds() / m_window.GetNanoSeconds();
+}
+
+uint32_t
+WindowedStatistics::GetSlot(uint64_t window) const
+{
+    return window % m_slots.size();
+}
+
+void
+WindowedStatistics::NotifySent(uint32_t node, uint32_t bytes, bool unicast)
+{
+    NodeWindow& stats = m_slots[GetSlot(GetWindowIndex(Simulator::Now()))][node];
+    stats.txPackets++;
+    stats.txBytes += bytes;
+    stats.unicastSent += unicast;
+}
+
+void
+WindowedStatistics::NotifyReceived(uint32_t node, uint32_t bytes, const FlsHeader& header)
+{
+    Time now = Simulator::Now();
+    int64_t delay = (now - header.GetSendTime()).GetNanoSeconds();
+    NodeWindow& stats = m_slots[GetSlot(GetWindowIndex(now))][node];
+    stats.rxPackets++;
+    stats.rxBytes += bytes;
+    stats.delaySum += delay;
+    stats.delayMax = std::max(stats.delayMax, delay);
+
+    // Deliveries after the send window was written count as losses
+    uint64_t sendWindow = GetWindowIndex(header.GetSendTime());
+    if (header.IsUnicast() && header.GetSendTime() >= m_start && sendWindow >= m_nextToWrite)
+    {
+        m_delivered[GetSlot(sendWindow)][header.GetSource()]++;
+    }
+}
+
+void
+WindowedStatistics::CloseWindow()
+{
+    uint64_t current = GetWindowIndex(Simulator::Now());
+    while (m_nextToWrite + m_graceWindows < current)
+    {
+        WriteWindow(m_nextToWrite++);
+    }
+    Time end = m_start + NanoSeconds(m_window.GetNanoSeconds() * (current + 1));
+    m_closeEvent =
+        Simulator::Schedule(end - Simulator::Now(), &WindowedStatistics::CloseWindow, this);
+}
+
+void
+WindowedStatistics::Finish()
+{
+    m_closeEvent.Cancel();
+    // Every window that has started, a last partial one included
+    int64_t elapsed = (Simulator::Now() - m_start).GetNanoSeconds();
+    uint64_t end = (elapsed + m_window.GetNanoSeconds() - 1) / m_window.GetNanoSeconds();
+    while (m_nextToWrite < end)
+    {
+        WriteWindow(m_nextToWrite++);
+    }
+    m_file.flush();
+}
+
+void
+WindowedStatistics::WriteWindow(uint64_t window)
+{
+    std::vector<NodeWindow>& slot = m_slots[GetSlot(window)];
+    std::vector<uint32_t>& delivered = m_delivered[GetSlot(window)];
+    uint64_t rxBytes = 0;
+    for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+        NodeWindow& stats = slot[i];
+        stats.unicastLost = stats.unicastSent - std::min(delivered[i], stats.unicastSent);
+
+        NodeWindow& total = m_totals[i];
+        total.txBytes += stats.txBytes;
+        total.rxBytes += stats.rxBytes;
+        total.delaySum += stats.delaySum;
+        total.delayMax = std::max(total.delayMax, stats.delayMax);
+        total.txPackets += stats.txPackets;
+        total.rxPackets += stats.rxPackets;
+        total.unicastSent += stats.unicastSent;
+        total.unicastLost += stats.unicastLost;
+        rxBytes += stats.rxBytes;
+    }
+    if (rxBytes > m_peakRxBytes)
+    {
+        m_peakRxBytes = rxBytes;
+        m_peakWindow = window;
+    }
+
+    if (m_file.is_open())
+    {
+        m_file.write(reinterpret_cast<const char*>(slot.data()), m_nNodes * sizeof(NodeWindow));
+    }
+    // The slot is reused for window + m_slots.size()
+    std::fill(slot.begin(), slot.end(), NodeWindow{});
+    std::fill(delivered.begin(), delivered.end(), 0);
+}
+
+Time
+WindowedStatistics::GetWindow() const
+{
+    return m_window;
+}
+
+uint32_t
+WindowedStatistics::GetNWindows() const
+{
+    return m_nextToWrite;
+}
+
+const WindowedStatistics::NodeWindow&
+WindowedStatistics::GetTotal(uint32_t node) const
+{
+    return m_totals[node];
+}
+
+void
+WindowedStatistics::PrintSummary(std::ostream& os) const
+{
+    os << "\n=== Windowed Statistics (" << GetNWindows() << " windows of "
+       << m_window.GetMilliSeconds() << " ms) ===\n";
+
+    NodeWindow swarm{};
+    for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+        const NodeWindow& total = m_totals[i];
+        os << "\nNode " << i << ":\n"
+           << "  Sent: " << total.txPackets << " packets (" << total.txBytes << " bytes)\n"
+           << "  Received: " << total.rxPackets << " packets (" << total.rxBytes << " bytes)\n"
+           << "  Lost Unicast: " << total.unicastLost << " of " << total.unicastSent << "\n";
+        if (total.rxPackets > 0)
+        {
+            os << "  Mean Delay: " << total.delaySum / 1e6 / total.rxPackets << " ms\n"
+               << "  Max Delay: " << total.delayMax / 1e6 << " ms\n";
+        }
+        swarm.txPackets += total.txPackets;
+        swarm.rxPackets += total.rxPackets;
+        swarm.rxBytes += total.rxBytes;
+        swarm.unicastSent += total.unicastSent;
+        swarm.unicastLost += total.unicastLost;
+    }
+
+    double seconds = m_window.GetSeconds();
+    os << "\nOverall:\n"
+       << "  Sent: " << swarm.txPackets << " packets, Received: " << swarm.rxPackets
+       << " packets\n"
+       << "  Unicast Loss Rate: "
+       << (swarm.unicastSent > 0 ? 100.0 * swarm.unicastLost / swarm.unicastSent : 0.0)
+       << "%\n"
+       << "  Mean Receive Rate: "
+       << (GetNWindows() > 0 ? swarm.rxBytes * 8.0 / (GetNWindows() * seconds) / 1e6 : 0.0)
+       << " Mbps\n"
+       << "  Peak Receive Rate: " << m_peakRxBytes * 8.0 / seconds / 1e6 << " Mbps in window "
+       << (m_start + NanoSeconds(m_window.GetNanoSeconds() * m_peakWindow)).GetSeconds()
+       << " s\n";
+}
+
+} // namespace ns3
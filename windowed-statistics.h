@@ -0,0 +1,88 @@
+#ifndef WINDOWED_STATISTICS_H
+#define WINDOWED_STATISTICS_H
+
+#include "fls-header.h"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// Per-node traffic statistics over fixed windows of simulation time. Each window is
+// appended to a file as soon as it is final, so memory does not grow with the run length.
+//
+// Sent and received counts go to the window they happen in. Delays go to the window of
+// the reception. A unicast packet counts as lost in its send window unless it arrives
+// within the grace period, so windows are written that much after they end.
+//
+// Statistics files ("FLSW") hold a 32-byte header (magic, version, node count, grace in
+// windows, window length and start time in ns) followed by one 48-byte NodeWindow record
+// per node for every window, in window order.
+class WindowedStatistics : public SimpleRefCount<WindowedStatistics>
+{
+  public:
+    struct NodeWindow
+    {
+        uint64_t txBytes;
+        uint64_t rxBytes;
+        int64_t delaySum; // nanoseconds, over the received packets
+        int64_t delayMax;
+        uint32_t txPackets;
+        uint32_t rxPackets;
+        uint32_t unicastSent;
+        uint32_t unicastLost;
+    };
+
+    WindowedStatistics(uint32_t nNodes, Time window, Time grace);
+
+    // Write windows to filename as they complete, false if it cannot be created
+    bool Open(const std::string& filename);
+    // Start closing windows from the current simulation time on
+    void Start();
+    // Close every remaining window, e.g. once the simulation has run
+    void Finish();
+
+    void NotifySent(uint32_t node, uint32_t bytes, bool unicast);
+    void NotifyReceived(uint32_t node, uint32_t bytes, const FlsHeader& header);
+
+    Time GetWindow() const;
+    uint32_t GetNWindows() const;
+    // Sums over every written window
+    const NodeWindow& GetTotal(uint32_t node) const;
+    // End-of-run report derived from the windows
+    void PrintSummary(std::ostream& os) const;
+
+  private:
+    uint64_t GetWindowIndex(Time t) const;
+    uint32_t GetSlot(uint64_t window) const;
+    void CloseWindow();
+    void WriteWindow(uint64_t window);
+
+    uint32_t m_nNodes;
+    Time m_window;
+    uint32_t m_graceWindows;
+    Time m_start;
+    std::ofstream m_file;
+    EventId m_closeEvent;
+
+    // Windows not written yet, ring indexed by window number
+    std::vector<std::vector<NodeWindow>> m_slots;
+    std::vector<std::vector<uint32_t>> m_delivered; // unicast packets delivered, same layout
+    uint64_t m_nextToWrite;
+
+    std::vector<NodeWindow> m_totals;
+    uint64_t m_peakRxBytes; // swarm-wide, over a single window
+    uint64_t m_peakWindow;
+};
+
+} // namespace ns3
+
+#endif // WINDOWED_STATISTICS_H